@@ -0,0 +1,140 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace NP
+{
+
+	// Bump allocator: memory is handed out from large chunks and only
+	// returned all at once, when the arena is destroyed or released to a
+	// mark. Not thread-safe; use one arena per thread.
+	class Bump_arena
+	{
+	public:
+		// position of the arena, see release()
+		struct Mark
+		{
+			std::size_t chunk;
+			std::size_t used;
+		};
+
+		explicit Bump_arena(std::size_t chunk_size = 64 * 1024)
+			: chunk_size(chunk_size), current(0), used(0), reserved(0)
+		{
+		}
+
+		Bump_arena(Bump_arena &&) = default;
+		Bump_arena &operator=(Bump_arena &&) = default;
+
+		void *allocate(std::size_t bytes, std::size_t align)
+		{
+			while (current < chunks.size())
+			{
+				std::size_t offset = aligned(chunks[current].first.get(), used,
+											 align);
+				if (offset + bytes <= chunks[current].second)
+				{
+					used = offset + bytes;
+					return chunks[current].first.get() + offset;
+				}
+				// try the next chunk, if one is left from before a release
+				current++;
+				used = 0;
+			}
+			std::size_t size = std::max(chunk_size, bytes + align);
+			chunks.emplace_back(std::unique_ptr<char[]>(new char[size]), size);
+			reserved += size;
+			current = chunks.size() - 1;
+			std::size_t offset = aligned(chunks[current].first.get(), 0, align);
+			used = offset + bytes;
+			return chunks[current].first.get() + offset;
+		}
+
+		Mark mark() const
+		{
+			return Mark{current, used};
+		}
+
+		// give back everything allocated since m; the chunks are kept for
+		// reuse
+		void release(const Mark &m)
+		{
+			current = m.chunk;
+			used = m.used;
+		}
+
+		// bytes obtained from the system allocator
+		std::size_t bytes_reserved() const
+		{
+			return reserved;
+		}
+
+	private:
+		std::size_t chunk_size;
+		std::vector<std::pair<std::unique_ptr<char[]>, std::size_t>> chunks;
+		// allocation position: chunk index and bytes used in that chunk
+		std::size_t current, used;
+		std::size_t reserved;
+
+		static std::size_t aligned(const char *base, std::size_t offset,
+								   std::size_t align)
+		{
+			auto addr = reinterpret_cast<std::uintptr_t>(base) + offset;
+			return offset + (align - addr % align) % align;
+		}
+	};
+
+	// STL allocator that takes its memory from a Bump_arena, or from the
+	// heap if it has no arena; deallocation into an arena is a no-op
+	template <class T>
+	struct Arena_allocator
+	{
+		typedef T value_type;
+
+		Bump_arena *arena;
+
+		Arena_allocator(Bump_arena *arena = nullptr) noexcept
+			: arena(arena)
+		{
+		}
+
+		template <class U>
+		Arena_allocator(const Arena_allocator<U> &other) noexcept
+			: arena(other.arena)
+		{
+		}
+
+		T *allocate(std::size_t n)
+		{
+			if (arena)
+				return static_cast<T *>(
+					arena->allocate(n * sizeof(T), alignof(T)));
+			return std::allocator<T>().allocate(n);
+		}
+
+		void deallocate(T *p, std::size_t n)
+		{
+			if (!arena)
+				std::allocator<T>().deallocate(p, n);
+		}
+
+		template <class U>
+		bool operator==(const Arena_allocator<U> &other) const
+		{
+			return arena == other.arena;
+		}
+
+		template <class U>
+		bool operator!=(const Arena_allocator<U> &other) const
+		{
+			return arena != other.arena;
+		}
+	};
+}
+
+#endif
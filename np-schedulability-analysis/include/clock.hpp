@@ -3,27 +3,59 @@
 
 #include <time.h>
 
+// Measures the CPU time of the whole process, which includes the workers
+// of a parallel analysis. Analyses that run side by side, one per thread
+// (see nptest --batch-jobs), measure the CPU time of their own thread
+// instead; such a clock must be read by the thread that started it.
 class Processor_clock {
 
 	private:
 
 	clock_t accum = 0, start_time = 0;
 	bool running = false;
+	bool of_thread = false;
 
 	static constexpr double scale_to_seconds = 1.0 / (double) CLOCKS_PER_SEC;
 
+	static bool &measure_threads()
+	{
+		static thread_local bool per_thread = false;
+		return per_thread;
+	}
+
+	clock_t now() const
+	{
+#ifndef _WIN32
+		if (of_thread) {
+			struct timespec t;
+			clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t);
+			return t.tv_sec * (clock_t) CLOCKS_PER_SEC
+			       + t.tv_nsec / (1000000000 / CLOCKS_PER_SEC);
+		}
+#endif
+		return clock();
+	}
+
 	public:
 
+	// whether the clocks started by the calling thread from now on
+	// measure its CPU time only
+	static void measure_calling_thread(bool per_thread)
+	{
+		measure_threads() = per_thread;
+	}
+
 	void start()
 	{
 		running = true;
-		start_time = clock();
+		of_thread = measure_threads();
+		start_time = now();
 	}
 
 
 	double stop()
 	{
-		auto delta = clock() - start_time;
+		auto delta = now() - start_time;
 		if (running) {
 			accum += delta;
 			running = false;
@@ -36,7 +68,7 @@ class Processor_clock {
 	operator double() const {
 		clock_t extra = 0;
 		if (running)
-			extra = clock() - start_time;
+			extra = now() - start_time;
 		return (accum + extra) * scale_to_seconds;
 	}
 
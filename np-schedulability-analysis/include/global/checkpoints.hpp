@@ -0,0 +1,70 @@
+#ifndef GLOBAL_CHECKPOINTS_HPP
+#define GLOBAL_CHECKPOINTS_HPP
+
+#include <deque>
+#include <vector>
+
+#include "interval.hpp"
+#include "jobs.hpp"
+#include "global/state.hpp"
+
+namespace NP {
+
+	namespace Global {
+
+		// Copies of the exploration fronts of some depths, taken while
+		// analyzing a workload (see Analysis_options::checkpoints). The
+		// analysis of a slightly changed workload can resume from the
+		// deepest front that none of the changes can reach, instead of
+		// exploring again from the initial state (see State_space::explore).
+		template<class Time> struct Exploration_checkpoints
+		{
+			typedef typename Job<Time>::Job_set Workload;
+			typedef Schedule_state<Time> State;
+
+			struct Checkpoint
+			{
+				// number of jobs scheduled in the states of the front
+				unsigned long depth;
+				// latest time examined while expanding the shallower
+				// depths; infinity if some expansion looked up the jobs
+				// by a window they were not eligible in (then anything may
+				// have mattered)
+				Time horizon;
+				std::deque<State> front;
+				// the finish times recorded while expanding the shallower
+				// depths, by job index
+				std::vector<Interval<Time>> finish_times;
+				std::vector<bool> finish_times_known;
+				// statistics of the shallower depths
+				unsigned long num_states, num_edges, width;
+			};
+
+			// the analyzed workload, and what of the analysis options the
+			// fronts depend on
+			Workload jobs;
+			std::vector<Job_precedence_set> predecessors;
+			unsigned int num_cpus;
+			bool be_naive;
+			// jobs whose finish times were recorded; empty if all were
+			std::vector<bool> finish_times_needed;
+			// see State_space::find_interchangeable_jobs; empty if the
+			// symmetry reduction was off
+			std::vector<Job_index> interchangeable_prev;
+
+			// by increasing depth
+			std::deque<Checkpoint> checkpoints;
+
+			Exploration_checkpoints() : num_cpus(0), be_naive(false)
+			{
+			}
+
+			bool empty() const
+			{
+				return checkpoints.empty();
+			}
+		};
+	}
+}
+
+#endif
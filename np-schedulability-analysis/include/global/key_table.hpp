@@ -0,0 +1,170 @@
+#ifndef GLOBAL_KEY_TABLE_HPP
+#define GLOBAL_KEY_TABLE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "jobs.hpp"
+
+namespace NP {
+
+	namespace Global {
+
+		// Concurrent map from (well-mixed) 64-bit keys to values. The keys
+		// are striped over shards by their top bits; each shard is an
+		// open-addressing table with linear probing, guarded by its own
+		// lock, and grows by itself. The values are accessed only while the
+		// lock of their shard is held, see with_value().
+		template<class Value> class Key_table
+		{
+			public:
+
+			struct Statistics
+			{
+				// calls of with_value(), and slots probed by them
+				unsigned long lookups, probes;
+				// longest probe sequence
+				unsigned long max_probe;
+
+				Statistics() : lookups(0), probes(0), max_probe(0)
+				{
+				}
+
+				Statistics &operator+=(const Statistics &other)
+				{
+					lookups += other.lookups;
+					probes += other.probes;
+					max_probe = std::max(max_probe, other.max_probe);
+					return *this;
+				}
+			};
+
+			Key_table() : shards(new Shard[NUM_SHARDS])
+			{
+			}
+
+			// calls f(value) with the value of the key, which is default
+			// constructed if the key is new, and returns the result
+			template<class F>
+			auto with_value(hash_value_t key, F f)
+				-> decltype(f(std::declval<Value &>()))
+			{
+				Shard &shard = shards[key >> (64 - SHARD_BITS)];
+				std::lock_guard<std::mutex> lock(shard.mutex);
+				return f(shard.find_or_insert(key));
+			}
+
+			// drops all keys and values, but keeps the capacity; not
+			// thread-safe
+			void clear()
+			{
+				for (std::size_t i = 0; i < NUM_SHARDS; i++)
+					shards[i].clear();
+			}
+
+			// not thread-safe
+			Statistics statistics() const
+			{
+				Statistics s;
+				for (std::size_t i = 0; i < NUM_SHARDS; i++)
+					s += shards[i].stats;
+				return s;
+			}
+
+			private:
+
+			static const std::size_t SHARD_BITS = 7;
+			static const std::size_t NUM_SHARDS = 1 << SHARD_BITS;
+
+			struct Slot
+			{
+				hash_value_t key;
+				bool used;
+				Value value;
+
+				Slot() : key(0), used(false)
+				{
+				}
+			};
+
+			struct Shard
+			{
+				std::mutex mutex;
+				std::vector<Slot> slots;
+				std::size_t size;
+				Statistics stats;
+				// keeps the locks of neighboring shards on different cache
+				// lines
+				char padding[64];
+
+				Shard() : size(0)
+				{
+				}
+
+				Value &find_or_insert(hash_value_t key)
+				{
+					// keep the load factor below 3/4
+					if (4 * (size + 1) > 3 * slots.size())
+						grow();
+					std::size_t mask = slots.size() - 1;
+					std::size_t i = key & mask;
+					unsigned long probes = 1;
+					while (slots[i].used && slots[i].key != key)
+					{
+						i = (i + 1) & mask;
+						probes++;
+					}
+					stats.lookups++;
+					stats.probes += probes;
+					stats.max_probe = std::max(stats.max_probe, probes);
+					if (!slots[i].used)
+					{
+						slots[i].used = true;
+						slots[i].key = key;
+						size++;
+					}
+					return slots[i].value;
+				}
+
+				void clear()
+				{
+					if (!size)
+						return;
+					for (Slot &s : slots)
+						if (s.used)
+						{
+							s.used = false;
+							s.value = Value();
+						}
+					size = 0;
+				}
+
+				void grow()
+				{
+					std::vector<Slot> old(std::max<std::size_t>(
+						8, 2 * slots.size()));
+					old.swap(slots);
+					std::size_t mask = slots.size() - 1;
+					for (Slot &s : old)
+						if (s.used)
+						{
+							std::size_t i = s.key & mask;
+							while (slots[i].used)
+								i = (i + 1) & mask;
+							slots[i].used = true;
+							slots[i].key = s.key;
+							slots[i].value = std::move(s.value);
+						}
+				}
+			};
+
+			std::unique_ptr<Shard[]> shards;
+		};
+	}
+}
+
+#endif
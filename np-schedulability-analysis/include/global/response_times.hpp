@@ -0,0 +1,225 @@
+#ifndef GLOBAL_RESPONSE_TIMES_HPP
+#define GLOBAL_RESPONSE_TIMES_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "config.h"
+
+#ifdef CONFIG_PARALLEL
+#include "tbb/enumerable_thread_specific.h"
+#endif
+
+#include "interval.hpp"
+#include "jobs.hpp"
+#include "time.hpp"
+
+namespace NP {
+
+	namespace Global {
+
+		// Finish-time bounds of the jobs, widened concurrently by the
+		// threads exploring a depth. During the exploration, jobs are
+		// identified both by their index in the workload and by the job
+		// itself; update() is thread-safe, and lookup() sees the bounds as of
+		// the last merge(), which the main thread calls after each depth (in
+		// the parallel exploration). find() is for the final results.
+
+		// One atomic [min, max] pair per job index, and no hashing. The
+		// merge only copies the flat array, so that the bounds read during a
+		// depth do not depend on the progress of the other threads.
+		template<class Time> class Atomic_response_times
+		{
+			public:
+
+			typedef typename Job<Time>::Job_set Workload;
+
+			Atomic_response_times(const Workload &jobs)
+			: num_jobs(jobs.size()),
+			  bounds(new Bounds[jobs.size()])
+#ifdef CONFIG_PARALLEL
+			  , published(jobs.size(), Published{no_from(), no_until()})
+#endif
+			{
+				index_of_id.reserve(jobs.size());
+				for (std::size_t i = 0; i < jobs.size(); i++)
+					index_of_id.emplace(jobs[i].get_id(), i);
+			}
+
+			void update(std::size_t index, const Job<Time>&,
+			            Interval<Time> range)
+			{
+				Bounds &b = bounds[index];
+				atomic_min(b.from, range.from());
+				atomic_max(b.until, range.upto());
+			}
+
+			// false if no finish time of the job has been recorded yet
+			bool lookup(std::size_t index, const Job<Time>&,
+			            Interval<Time> &range) const
+			{
+#ifdef CONFIG_PARALLEL
+				const Published &p = published[index];
+				if (p.from > p.until)
+					return false;
+				range = Interval<Time>{p.from, p.until};
+				return true;
+#else
+				return bounds_of(index, range);
+#endif
+			}
+
+			void merge()
+			{
+#ifdef CONFIG_PARALLEL
+				for (std::size_t i = 0; i < num_jobs; i++)
+					published[i] = Published{
+						bounds[i].from.load(std::memory_order_relaxed),
+						bounds[i].until.load(std::memory_order_relaxed)};
+#endif
+			}
+
+			bool find(const JobID &id, Interval<Time> &range) const
+			{
+				auto idx = index_of_id.find(id);
+				if (idx == index_of_id.end())
+					return false;
+				return bounds_of(idx->second, range);
+			}
+
+			private:
+
+			// empty while from > until
+			struct Bounds
+			{
+				std::atomic<Time> from, until;
+
+				Bounds()
+				: from(no_from()), until(no_until())
+				{
+				}
+			};
+
+			struct Published
+			{
+				Time from, until;
+			};
+
+			std::size_t num_jobs;
+			std::unique_ptr<Bounds[]> bounds;
+#ifdef CONFIG_PARALLEL
+			std::vector<Published> published;
+#endif
+			std::unordered_map<JobID, std::size_t> index_of_id;
+
+			static Time no_from()
+			{
+				return Time_model::constants<Time>::infinity();
+			}
+
+			static Time no_until()
+			{
+				return -Time_model::constants<Time>::infinity();
+			}
+
+			bool bounds_of(std::size_t index, Interval<Time> &range) const
+			{
+				const Bounds &b = bounds[index];
+				Time from = b.from.load(std::memory_order_relaxed);
+				Time until = b.until.load(std::memory_order_relaxed);
+				// not set yet, or observed in the middle of the first update
+				if (from > until)
+					return false;
+				range = Interval<Time>{from, until};
+				return true;
+			}
+
+			static void atomic_min(std::atomic<Time> &a, Time x)
+			{
+				Time cur = a.load(std::memory_order_relaxed);
+				while (x < cur && !a.compare_exchange_weak(
+				           cur, x, std::memory_order_relaxed))
+					;
+			}
+
+			static void atomic_max(std::atomic<Time> &a, Time x)
+			{
+				Time cur = a.load(std::memory_order_relaxed);
+				while (x > cur && !a.compare_exchange_weak(
+				           cur, x, std::memory_order_relaxed))
+					;
+			}
+		};
+
+		// The original bookkeeping: a hash map per thread, merged into the
+		// shared map after each depth. Kept for comparison.
+		template<class Time> class Hashed_response_times
+		{
+			public:
+
+			typedef typename Job<Time>::Job_set Workload;
+
+			Hashed_response_times(const Workload &)
+			{
+			}
+
+			void update(std::size_t, const Job<Time>& j,
+			            Interval<Time> range)
+			{
+#ifdef CONFIG_PARALLEL
+				widen(partial_rta.local(), j.get_id(), range);
+#else
+				widen(rta, j.get_id(), range);
+#endif
+			}
+
+			bool lookup(std::size_t, const Job<Time>& j,
+			            Interval<Time> &range) const
+			{
+				return find(j.get_id(), range);
+			}
+
+			bool find(const JobID &id, Interval<Time> &range) const
+			{
+				auto rbounds = rta.find(id);
+				if (rbounds == rta.end())
+					return false;
+				range = rbounds->second;
+				return true;
+			}
+
+			void merge()
+			{
+#ifdef CONFIG_PARALLEL
+				for (auto &r : partial_rta)
+					for (const auto &elem : r)
+						widen(rta, elem.first, elem.second);
+#endif
+			}
+
+			private:
+
+			typedef std::unordered_map<JobID, Interval<Time>> Map;
+
+			Map rta;
+
+#ifdef CONFIG_PARALLEL
+			tbb::enumerable_thread_specific<Map> partial_rta;
+#endif
+
+			static void widen(Map &r, const JobID &id, Interval<Time> range)
+			{
+				auto rbounds = r.find(id);
+				if (rbounds == r.end())
+					r.emplace(id, range);
+				else
+					rbounds->second |= range;
+			}
+		};
+	}
+}
+
+#endif
@@ -7,6 +7,11 @@
 #include <deque>
 #include <forward_list>
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <tuple>
 
 #include <iostream>
 #include <ostream>
@@ -15,15 +20,19 @@
 #include "config.h"
 
 #ifdef CONFIG_PARALLEL
-#include "tbb/concurrent_hash_map.h"
 #include "tbb/enumerable_thread_specific.h"
 #include "tbb/parallel_for.h"
 #endif
 
 #include "problem.hpp"
+#include "util.hpp"
 #include "clock.hpp"
+#include "trace.hpp"
 
 #include "global/state.hpp"
+#include "global/response_times.hpp"
+#include "global/key_table.hpp"
+#include "global/checkpoints.hpp"
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wreorder"
@@ -34,17 +43,23 @@ namespace NP
 	namespace Global
 	{
 
-		template <class Time>
+		template <class Time, class Response_times = Atomic_response_times<Time>>
 		class State_space
 		{
 		public:
 			typedef Scheduling_problem<Time> Problem;
 			typedef typename Scheduling_problem<Time>::Workload Workload;
 			typedef Schedule_state<Time> State;
+			typedef Exploration_checkpoints<Time> Checkpoints;
 
+			// If the checkpoints of a previous analysis are given, the
+			// exploration resumes from one of them if possible (see
+			// resume()). With CONFIG_COLLECT_SCHEDULE_GRAPH, the graph then
+			// lacks the depths before it.
 			static State_space explore(
 				const Problem &prob,
-				const Analysis_options &opts)
+				const Analysis_options &opts,
+				const Checkpoints *previous = nullptr)
 			{
 				// doesn't yet support exploration after deadline miss
 				assert(opts.early_exit);
@@ -52,9 +67,28 @@ namespace NP
 				auto s = State_space(prob.jobs, prob.dag, prob.num_processors, opts.timeout,
 									 opts.max_depth, opts.num_buckets);
 				s.be_naive = opts.be_naive;
+				s.memory_budget = opts.memory_budget;
+				if (opts.symmetry_reduction)
+					s.find_interchangeable_jobs();
+				s.schedulability_only = opts.schedulability_only;
+				if (opts.schedulability_only)
+					s.keep_only_needed_finish_times();
+				if (opts.checkpoints)
+					s.keep_checkpoints(opts.checkpoints);
+				std::unique_ptr<Graph_trace_writer<Time>> trace;
+				if (opts.graph_trace)
+				{
+					trace.reset(new Graph_trace_writer<Time>(
+						*opts.graph_trace, prob.jobs, Trace_states::global,
+						prob.num_processors));
+					s.trace = trace.get();
+				}
 				s.cpu_time.start();
+				if (previous)
+					s.resume(*previous);
 				s.explore();
 				s.cpu_time.stop();
+				s.trace = nullptr;
 				return s;
 			}
 
@@ -79,17 +113,13 @@ namespace NP
 				return explore(p, o);
 			}
 
+			// with Analysis_options::schedulability_only, [0, infinity] for
+			// the jobs without successors
 			Interval<Time> get_finish_times(const Job<Time> &j) const
 			{
-				auto rbounds = rta.find(j.get_id());
-				if (rbounds == rta.end())
-				{
-					return Interval<Time>{0, Time_model::constants<Time>::infinity()};
-				}
-				else
-				{
-					return rbounds->second;
-				}
+				Interval<Time> range{0, Time_model::constants<Time>::infinity()};
+				rta.find(j.get_id(), range);
+				return range;
 			}
 
 			bool is_schedulable() const
@@ -102,6 +132,22 @@ namespace NP
 				return timed_out;
 			}
 
+			// the analysis was aborted because the states of two consecutive
+			// depths exceeded Analysis_options::memory_budget; the result
+			// is then unknown, just as after a time-out
+			bool was_out_of_memory() const
+			{
+				return out_of_memory;
+			}
+
+			// largest memory (in bytes) taken by the states of the
+			// exploration front and of the next depth, including their
+			// arenas, measured at the end of every depth
+			std::size_t peak_frontier_memory() const
+			{
+				return peak_frontier_bytes;
+			}
+
 			unsigned long number_of_states() const
 			{
 				return num_states;
@@ -117,18 +163,50 @@ namespace NP
 				return width;
 			}
 
+			// how well the lookup keys of the states spread: the lookups in
+			// the table of states to merge with, the slots they probed, and
+			// the cached states that new states were compared with; of the
+			// latter, collisions had the same key but other scheduled jobs
+			struct Hash_statistics
+			{
+				unsigned long lookups, probes, max_probe;
+				unsigned long candidates, collisions;
+			};
+
+			Hash_statistics hash_statistics() const
+			{
+				return hash_stats;
+			}
+
 			double get_cpu_time() const
 			{
 				return cpu_time;
 			}
 
+			// depth of the checkpoint the exploration resumed from, or zero
+			unsigned long resumed_depth() const
+			{
+				return resumed_at;
+			}
+
+			// the checkpoints kept with Analysis_options::checkpoints, for
+			// the analysis of the next workload
+			Checkpoints take_checkpoints()
+			{
+				return std::move(checkpoints);
+			}
+
 			typedef std::deque<State> States;
 
 #ifdef CONFIG_PARALLEL
 			typedef tbb::enumerable_thread_specific<States> Split_states;
 			typedef std::deque<Split_states> States_storage;
+			// the payloads of the states of one depth, one arena per thread
+			typedef tbb::enumerable_thread_specific<Bump_arena> Split_arenas;
+			typedef std::deque<Split_arenas> Arenas_storage;
 #else
 			typedef std::deque<States> States_storage;
+			typedef std::deque<Bump_arena> Arenas_storage;
 #endif
 
 #ifdef CONFIG_COLLECT_SCHEDULE_GRAPH
@@ -187,21 +265,14 @@ namespace NP
 			typedef typename std::deque<State>::iterator State_ref;
 			typedef typename std::forward_list<State_ref> State_refs;
 
-#ifdef CONFIG_PARALLEL
-			typedef tbb::concurrent_hash_map<hash_value_t, State_refs> States_map;
-			typedef typename States_map::accessor States_map_accessor;
-#else
-			typedef std::unordered_map<hash_value_t, State_refs> States_map;
-#endif
+			typedef Key_table<State_refs> States_map;
 
 			typedef const Job<Time> *Job_ref;
-			typedef std::multimap<Time, Job_ref> By_time_map;
+			typedef Sorted_multimap<Time, Job_ref> By_time_map;
 
 			typedef std::deque<State_ref> Todo_queue;
 
-			typedef Interval_lookup_table<Time, Job<Time>, Job<Time>::scheduling_window> Jobs_lut;
-
-			typedef std::unordered_map<JobID, Interval<Time>> Response_times;
+			typedef Interval_lookup_array<Time, Job<Time>, Job<Time>::scheduling_window> Jobs_lut;
 
 #ifdef CONFIG_COLLECT_SCHEDULE_GRAPH
 			std::deque<Edge> edges;
@@ -209,12 +280,31 @@ namespace NP
 
 			Response_times rta;
 
-#ifdef CONFIG_PARALLEL
-			tbb::enumerable_thread_specific<Response_times> partial_rta;
-#endif
-
 			bool aborted;
 			bool timed_out;
+			bool out_of_memory;
+
+			// std::atomic is not movable, but State_space is returned by value
+			struct Byte_counter
+			{
+				std::atomic<std::size_t> bytes;
+
+				Byte_counter() : bytes(0)
+				{
+				}
+
+				Byte_counter(const Byte_counter &other)
+					: bytes(other.bytes.load())
+				{
+				}
+			};
+
+			std::size_t memory_budget;
+			// memory of the states of the exploration front, and of the
+			// depth being built (updated concurrently)
+			std::size_t front_bytes;
+			Byte_counter next_front_bytes;
+			std::size_t peak_frontier_bytes;
 
 			const unsigned int max_depth;
 
@@ -222,6 +312,17 @@ namespace NP
 
 			const Workload &jobs;
 
+			// for every job, the interchangeable job of next higher priority
+			// (see find_interchangeable_jobs), or no_job; empty if the
+			// reduction is off
+			static constexpr Job_index no_job = (Job_index)-1;
+			std::vector<Job_index> interchangeable_prev;
+
+			bool schedulability_only;
+			// whether the finish times of a job are recorded, with
+			// schedulability_only
+			std::vector<bool> finish_times_needed;
+
 			// not touched after initialization
 			Jobs_lut _jobs_by_win;
 			By_time_map _jobs_by_latest_arrival;
@@ -236,6 +337,8 @@ namespace NP
 			const By_time_map &jobs_by_deadline;
 			const std::vector<Job_precedence_set> &predecessors;
 
+			// declared before states_storage, which must be destroyed first
+			Arenas_storage arenas_storage;
 			States_storage states_storage;
 
 			States_map states_by_key;
@@ -247,6 +350,58 @@ namespace NP
 #ifdef CONFIG_PARALLEL
 			tbb::enumerable_thread_specific<unsigned long> edge_counter;
 #endif
+
+			struct Merge_counters
+			{
+				unsigned long candidates, collisions;
+
+				Merge_counters() : candidates(0), collisions(0)
+				{
+				}
+			};
+
+#ifdef CONFIG_PARALLEL
+			tbb::enumerable_thread_specific<Merge_counters> merge_counters;
+#else
+			Merge_counters merge_counters;
+#endif
+			Hash_statistics hash_stats;
+
+			typedef typename Checkpoints::Checkpoint Checkpoint;
+			// a checkpoint is kept every checkpoint_stride depths, if not
+			// zero
+			std::size_t checkpoint_stride;
+			Checkpoints checkpoints;
+			std::vector<Job_index> identity;
+			unsigned long resumed_at;
+			// latest time examined by the expansions of the finished
+			// depths, and of the depth being expanded (updated
+			// concurrently)
+			Time horizon;
+#ifdef CONFIG_PARALLEL
+			tbb::enumerable_thread_specific<Time> depth_horizon;
+#else
+			Time depth_horizon;
+#endif
+
+			// the schedule graph is streamed to it, if given
+			Graph_trace_writer<Time> *trace;
+			// the edges into the depth being built, and the numbers in the
+			// trace of the states of the exploration front
+			struct Trace_edge
+			{
+				const State *source;
+				const State *target;
+				Job_index job;
+				Interval<Time> finish_range;
+			};
+#ifdef CONFIG_PARALLEL
+			tbb::enumerable_thread_specific<std::vector<Trace_edge>> trace_edges;
+#else
+			std::vector<Trace_edge> trace_edges;
+#endif
+			std::unordered_map<const State *, std::uint64_t> trace_ids;
+
 			Processor_clock cpu_time;
 			const double timeout;
 
@@ -258,17 +413,13 @@ namespace NP
 						double max_cpu_time = 0,
 						unsigned int max_depth = 0,
 						std::size_t num_buckets = 1000)
-				: aborted(false), timed_out(false), max_depth(max_depth), be_naive(false), jobs(jobs), _jobs_by_win(Interval<Time>{0, max_deadline(jobs)},
-																													max_deadline(jobs) / num_buckets),
+				: rta(jobs), aborted(false), timed_out(false), out_of_memory(false), memory_budget(0), front_bytes(0), next_front_bytes(), peak_frontier_bytes(0), hash_stats(), checkpoint_stride(0), resumed_at(0), horizon(0), trace(nullptr), schedulability_only(false), max_depth(max_depth), be_naive(false), jobs(jobs), _jobs_by_win(Interval<Time>{0, max_deadline(jobs)},
+																													max_deadline(jobs) / num_buckets, jobs),
 				  timeout(max_cpu_time), num_states(0), num_edges(0), width(0), current_job_count(0), num_cpus(num_cpus), jobs_by_latest_arrival(_jobs_by_latest_arrival), jobs_by_earliest_arrival(_jobs_by_earliest_arrival), jobs_by_deadline(_jobs_by_deadline), jobs_by_win(_jobs_by_win), _predecessors(jobs.size()), predecessors(_predecessors)
 			{
-				for (const Job<Time> &j : jobs)
-				{
-					_jobs_by_latest_arrival.insert({j.latest_arrival(), &j});
-					_jobs_by_earliest_arrival.insert({j.earliest_arrival(), &j});
-					_jobs_by_deadline.insert({j.get_deadline(), &j});
-					_jobs_by_win.insert(j);
-				}
+				_jobs_by_latest_arrival = by_time(jobs, &Job<Time>::latest_arrival);
+				_jobs_by_earliest_arrival = by_time(jobs, &Job<Time>::earliest_arrival);
+				_jobs_by_deadline = by_time(jobs, &Job<Time>::get_deadline);
 
 				for (auto e : dag_edges)
 				{
@@ -296,38 +447,410 @@ namespace NP
 				return dl;
 			}
 
-			void update_finish_times(Response_times &r, const JobID &id,
-									 Interval<Time> range)
+			// the jobs ordered by the given time, in index order among equal
+			// times
+			static By_time_map by_time(const Workload &jobs,
+									   Time (Job<Time>::*time)() const)
 			{
-				auto rbounds = r.find(id);
-				if (rbounds == r.end())
+				std::vector<typename By_time_map::value_type> entries;
+				entries.reserve(jobs.size());
+				for (const Job<Time> &j : jobs)
+					entries.emplace_back((j.*time)(), &j);
+				return By_time_map(entries);
+			}
+
+			// the finish times recorded so far, during the exploration
+			Interval<Time> finish_times_of(Job_index i) const
+			{
+				Interval<Time> range{0, Time_model::constants<Time>::infinity()};
+				rta.lookup(i, jobs[i], range);
+				return range;
+			}
+
+			void update_finish_times(const Job<Time> &j, Interval<Time> range)
+			{
+				// with schedulability_only, only the deadline-miss test may
+				// be left
+				if (!schedulability_only || finish_times_needed[index_of(j)])
+				{
+					rta.update(index_of(j), j, range);
+					DM("RTA " << j.get_id() << ": " << get_finish_times(j)
+							  << std::endl);
+				}
+				if (j.exceeds_deadline(range.upto()))
+					aborted = true;
+			}
+
+			// schedulability-only mode: ready_times() needs the finish times
+			// of the predecessors, no others are recorded
+			void keep_only_needed_finish_times()
+			{
+				finish_times_needed.assign(jobs.size(), false);
+				for (const auto &preds : predecessors)
+					for (Job_index p : preds)
+						finish_times_needed[p] = true;
+			}
+
+			// Jobs that are released at the same instant and have the same
+			// predecessors are interchangeable: whenever two of them are
+			// ready, the one of higher priority is certainly ready no later
+			// than the other, which therefore cannot start first (see
+			// start_times). Only the canonical order, by priority, needs to
+			// be tried, and the finish-time bounds are exactly the same.
+			void find_interchangeable_jobs()
+			{
+				auto n = jobs.size();
+				std::vector<Job_precedence_set> preds(n);
+				for (Job_index i = 0; i < n; i++)
+				{
+					preds[i] = predecessors[i];
+					std::sort(preds[i].begin(), preds[i].end());
+				}
+
+				auto release = [&](Job_index i)
 				{
-					r.emplace(id, range);
+					return std::make_tuple(jobs[i].earliest_arrival(),
+										   std::cref(preds[i]));
+				};
+				// interchangeable jobs become adjacent, in priority order
+				std::vector<Job_index> order(n);
+				std::iota(order.begin(), order.end(), 0);
+				std::sort(order.begin(), order.end(),
+						  [&](Job_index a, Job_index b)
+						  {
+							  if (release(a) != release(b))
+								  return release(a) < release(b);
+							  return jobs[a].higher_priority_than(jobs[b]);
+						  });
+
+				interchangeable_prev.assign(n, no_job);
+				for (std::size_t i = 1; i < n; i++)
+				{
+					Job_index a = order[i - 1], b = order[i];
+					// a must not be able to finish at its deadline when it
+					// starts there, or b could start first without a miss
+					if (jobs[a].earliest_arrival() == jobs[a].latest_arrival() &&
+						jobs[b].earliest_arrival() == jobs[b].latest_arrival() &&
+						jobs[a].least_cost() > 0 && release(a) == release(b))
+						interchangeable_prev[b] = a;
 				}
-				else
+			}
+
+			// with the reduction, a job is dispatched only after the
+			// interchangeable job of next higher priority
+			bool canonical(const State &s, const Job<Time> &j) const
+			{
+				if (interchangeable_prev.empty())
+					return true;
+				Job_index prev = interchangeable_prev[index_of(j)];
+				return prev == no_job || !s.job_incomplete(prev);
+			}
+
+			bool records_finish_times(Job_index j) const
+			{
+				return !schedulability_only || finish_times_needed[j];
+			}
+
+			void keep_checkpoints(unsigned int count)
+			{
+				checkpoint_stride = std::max<std::size_t>(1, jobs.size() / count);
+				identity.resize(jobs.size());
+				std::iota(identity.begin(), identity.end(), 0);
+				checkpoints.jobs = jobs;
+				checkpoints.predecessors = predecessors;
+				checkpoints.num_cpus = num_cpus;
+				checkpoints.be_naive = be_naive;
+				if (schedulability_only)
+					checkpoints.finish_times_needed = finish_times_needed;
+				checkpoints.interchangeable_prev = interchangeable_prev;
+#ifndef CONFIG_PARALLEL
+				depth_horizon = 0;
+#endif
+			}
+
+			// copies the exploration front, at the top of a depth
+			void keep_checkpoint()
+			{
+				checkpoints.checkpoints.emplace_back();
+				Checkpoint &cp = checkpoints.checkpoints.back();
+				cp.depth = current_job_count;
+				cp.horizon = horizon;
+				const std::vector<hash_value_t> same_keys;
+#ifdef CONFIG_PARALLEL
+				for (const States &part : states_storage.back())
+					for (const State &s : part)
+						cp.front.emplace_back(s, identity, same_keys);
+#else
+				for (const State &s : states_storage.back())
+					cp.front.emplace_back(s, identity, same_keys);
+#endif
+				cp.finish_times.reserve(jobs.size());
+				for (Job_index i = 0; i < jobs.size(); i++)
 				{
-					rbounds->second |= range;
+					Interval<Time> range{0, 0};
+					bool known = rta.lookup(i, jobs[i], range);
+					cp.finish_times.push_back(range);
+					cp.finish_times_known.push_back(known);
 				}
-				DM("RTA " << id << ": " << r.find(id)->second << std::endl);
+				cp.num_states = num_states;
+				cp.width = width;
+				cp.num_edges = num_edges;
+#ifdef CONFIG_PARALLEL
+				for (auto c : edge_counter)
+					cp.num_edges += c;
+#endif
 			}
 
-			void update_finish_times(
-				Response_times &r, const Job<Time> &j, Interval<Time> range)
+			// keeps a checkpoint of a previous analysis, for this workload
+			void keep_checkpoint(const Checkpoint &from,
+								 const std::vector<Job_index> &to_old,
+								 const std::vector<Job_index> &to_new,
+								 const std::vector<hash_value_t> &key_change)
 			{
-				update_finish_times(r, j.get_id(), range);
-				if (j.exceeds_deadline(range.upto()))
-					aborted = true;
+				checkpoints.checkpoints.emplace_back();
+				Checkpoint &cp = checkpoints.checkpoints.back();
+				cp.depth = from.depth;
+				cp.horizon = from.horizon;
+				for (const State &s : from.front)
+					cp.front.emplace_back(s, to_new, key_change);
+				cp.finish_times.reserve(jobs.size());
+				for (Job_index j = 0; j < jobs.size(); j++)
+				{
+					Job_index i = to_old[j];
+					bool known = i != no_job && from.finish_times_known[i];
+					cp.finish_times.push_back(
+						known ? from.finish_times[i] : Interval<Time>{0, 0});
+					cp.finish_times_known.push_back(known);
+				}
+				cp.num_states = from.num_states;
+				cp.width = from.width;
+				cp.num_edges = from.num_edges;
 			}
 
-			void update_finish_times(const Job<Time> &j, Interval<Time> range)
+			void note_horizon(Time t)
+			{
+#ifdef CONFIG_PARALLEL
+				Time &h = depth_horizon.local();
+#else
+				Time &h = depth_horizon;
+#endif
+				h = std::max(h, t);
+			}
+
+			void fold_horizon()
 			{
-				Response_times &r =
 #ifdef CONFIG_PARALLEL
-					partial_rta.local();
+				for (Time h : depth_horizon)
+					horizon = std::max(horizon, h);
 #else
-					rta;
+				horizon = std::max(horizon, depth_horizon);
 #endif
-				update_finish_times(r, j, range);
+			}
+
+			// whether the scheduling window of an unfinished job ends just
+			// before t_min, so that looking up the jobs by t_min may or may
+			// not find it, depending on the buckets of jobs_by_win
+			bool window_just_passed(const State &s, Time t_min) const
+			{
+				auto until = t_min + Time_model::constants<Time>::epsilon();
+				for (auto it = jobs_by_deadline.lower_bound(t_min);
+					 it != jobs_by_deadline.end() && it->first < until; it++)
+					if (unfinished(s, *it->second))
+						return true;
+				return false;
+			}
+
+			// Resumes the exploration from the deepest checkpoint of a
+			// previous analysis that the differences between its workload
+			// and this one cannot reach, if any.
+			//
+			// The jobs of the two workloads are paired up by their
+			// parameters; a pair is unchanged if also the deadlines, the
+			// (paired) predecessors and the interchangeable jobs are the
+			// same. Any other job is looked at neither before its arrival
+			// nor before its deadline. So, if no expansion before the
+			// front examined any time at or after the earliest of those,
+			// the unchanged jobs were dispatched in the same order and with
+			// the same start times in both workloads, and the front and
+			// the finish times recorded so far are the same.
+			bool resume(const Checkpoints &previous)
+			{
+				const Workload &old_jobs = previous.jobs;
+				if (previous.empty() || previous.num_cpus != num_cpus ||
+					previous.be_naive != be_naive)
+					return false;
+
+				// (1) pair up the jobs of the same task with the same
+				// arrival, cost and priority, in index order
+				typedef std::tuple<unsigned long, Time, Time, Time, Time, Time>
+					Params;
+				auto params = [](const Job<Time> &j)
+				{
+					return Params{j.get_task_id(), j.earliest_arrival(),
+								  j.latest_arrival(), j.least_cost(),
+								  j.maximal_cost(), j.get_priority()};
+				};
+				std::map<Params, std::deque<Job_index>> unpaired;
+				for (Job_index i = 0; i < old_jobs.size(); i++)
+					unpaired[params(old_jobs[i])].push_back(i);
+				std::vector<Job_index> to_new(old_jobs.size(), no_job);
+				std::vector<Job_index> to_old(jobs.size(), no_job);
+				for (Job_index j = 0; j < jobs.size(); j++)
+				{
+					auto match = unpaired.find(params(jobs[j]));
+					if (match == unpaired.end() || match->second.empty())
+						continue;
+					to_old[j] = match->second.front();
+					to_new[to_old[j]] = j;
+					match->second.pop_front();
+				}
+
+				// the pairs must be ordered alike by index (the order of
+				// the lookups) and by ID (the tie-break of priorities)
+				std::vector<Job_index> paired;
+				for (Job_index j = 0; j < jobs.size(); j++)
+					if (to_old[j] != no_job)
+					{
+						if (!paired.empty() && to_old[paired.back()] > to_old[j])
+							return false;
+						paired.push_back(j);
+					}
+				auto id = [](const Job<Time> &j)
+				{
+					return std::make_pair(j.get_task_id(), j.get_job_id());
+				};
+				std::sort(paired.begin(), paired.end(),
+						  [&](Job_index a, Job_index b)
+						  {
+							  return id(old_jobs[to_old[a]]) <
+									 id(old_jobs[to_old[b]]);
+						  });
+				for (std::size_t k = 1; k < paired.size(); k++)
+					if (!(id(jobs[paired[k - 1]]) < id(jobs[paired[k]])))
+						return false;
+
+				// (2) find the earliest time a difference can be seen
+				auto same_predecessors = [&](Job_index i, Job_index j)
+				{
+					Job_precedence_set mapped, own(predecessors[j]);
+					for (Job_index p : previous.predecessors[i])
+					{
+						if (to_new[p] == no_job)
+							return false;
+						mapped.push_back(to_new[p]);
+					}
+					std::sort(mapped.begin(), mapped.end());
+					std::sort(own.begin(), own.end());
+					return mapped == own;
+				};
+				auto same_interchangeable = [&](Job_index i, Job_index j)
+				{
+					Job_index p = previous.interchangeable_prev.empty()
+									  ? no_job
+									  : previous.interchangeable_prev[i];
+					Job_index q = interchangeable_prev.empty()
+									  ? no_job
+									  : interchangeable_prev[j];
+					return p == no_job ? q == no_job
+									   : to_new[p] != no_job && to_new[p] == q;
+				};
+				auto recorded = [&](Job_index i)
+				{
+					return previous.finish_times_needed.empty() ||
+						   previous.finish_times_needed[i];
+				};
+				auto soonest = [](const Job<Time> &j)
+				{
+					return std::min(j.earliest_arrival(), j.get_deadline());
+				};
+
+				const Time never = Time_model::constants<Time>::infinity();
+				Time reach = never;
+				// jobs that are due earlier, and may have finished too late
+				// for their new deadline already
+				std::vector<Job_index> due_earlier;
+				for (Job_index i = 0; i < old_jobs.size(); i++)
+					if (to_new[i] == no_job)
+						reach = std::min(reach, soonest(old_jobs[i]));
+				for (Job_index j = 0; j < jobs.size(); j++)
+				{
+					Job_index i = to_old[j];
+					if (i == no_job)
+						reach = std::min(reach, soonest(jobs[j]));
+					else if (!same_predecessors(i, j) ||
+							 !same_interchangeable(i, j) ||
+							 (records_finish_times(j) && !recorded(i)))
+						reach = std::min(reach, std::min(soonest(jobs[j]),
+														 soonest(old_jobs[i])));
+					else if (jobs[j].get_deadline() != old_jobs[i].get_deadline())
+					{
+						reach = std::min(reach,
+										 std::min(jobs[j].get_deadline(),
+												  old_jobs[i].get_deadline()));
+						if (jobs[j].get_deadline() < old_jobs[i].get_deadline())
+							due_earlier.push_back(j);
+					}
+				}
+
+				// (3) pick the deepest checkpoint out of reach
+				const Checkpoint *from = nullptr;
+				for (auto cp = previous.checkpoints.rbegin();
+					 cp != previous.checkpoints.rend() && !from; cp++)
+				{
+					Time cp_reach = reach;
+					for (Job_index j : due_earlier)
+					{
+						Job_index i = to_old[j];
+						if (!cp->finish_times_known[i] ||
+							jobs[j].exceeds_deadline(cp->finish_times[i].upto()))
+							cp_reach = std::min(cp_reach, jobs[j].earliest_arrival());
+					}
+					if (cp->horizon != never &&
+						cp->horizon < cp_reach - Time_model::constants<Time>::epsilon())
+						from = &*cp;
+				}
+				if (!from)
+					return false;
+
+				// (4) restore the front, the finish times and the statistics
+				std::vector<hash_value_t> key_change(old_jobs.size(), 0);
+				for (Job_index i = 0; i < old_jobs.size(); i++)
+					if (to_new[i] != no_job)
+						key_change[i] = old_jobs[i].get_key() ^
+										jobs[to_new[i]].get_key();
+
+				states_storage.emplace_back();
+				arenas_storage.emplace_back();
+				for (const State &s : from->front)
+				{
+					Bump_arena &a = arena();
+					auto reserved = a.bytes_reserved();
+					states().emplace_back(s, to_new, key_change, &a);
+					count_memory(sizeof(State) + a.bytes_reserved() - reserved);
+				}
+
+				for (Job_index i = 0; i < old_jobs.size(); i++)
+				{
+					Job_index j = to_new[i];
+					if (j != no_job && from->finish_times_known[i] &&
+						records_finish_times(j))
+						rta.update(j, jobs[j], from->finish_times[i]);
+				}
+				rta.merge();
+
+				current_job_count = from->depth;
+				num_states = from->num_states;
+				num_edges = from->num_edges;
+				width = from->width;
+				horizon = from->horizon;
+				resumed_at = from->depth;
+
+				// the shallower checkpoints are still valid
+				if (checkpoint_stride)
+					for (const Checkpoint &cp : previous.checkpoints)
+						if (cp.depth <= from->depth)
+							keep_checkpoint(cp, to_old, to_new, key_change);
+				return true;
 			}
 
 			std::size_t index_of(const Job<Time> &j) const
@@ -344,6 +867,8 @@ namespace NP
 			{
 				auto check_from = old_s.core_availability().min();
 				auto earliest = new_s.core_availability().min();
+				if (checkpoint_stride)
+					note_horizon(earliest);
 
 				// check if we skipped any jobs that are now guaranteed
 				// to miss their deadline
@@ -370,6 +895,7 @@ namespace NP
 #ifdef CONFIG_COLLECT_SCHEDULE_GRAPH
 							edges.emplace_back(&j, &new_s, &next, frange);
 #endif
+							trace_edge(new_s, next, index_of(j), frange);
 							count_edge();
 							break;
 						}
@@ -384,6 +910,7 @@ namespace NP
 			{
 				// construct initial state
 				states_storage.emplace_back();
+				arenas_storage.emplace_back();
 				new_state(num_cpus);
 			}
 
@@ -396,11 +923,24 @@ namespace NP
 #endif
 			}
 
+			// arena of the states of the depth under construction
+			Bump_arena &arena()
+			{
+#ifdef CONFIG_PARALLEL
+				return arenas_storage.back().local();
+#else
+				return arenas_storage.back();
+#endif
+			}
+
 			template <typename... Args>
 			State_ref alloc_state(Args &&...args)
 			{
-				states().emplace_back(std::forward<Args>(args)...);
+				Bump_arena &a = arena();
+				auto reserved = a.bytes_reserved();
+				states().emplace_back(std::forward<Args>(args)..., &a);
 				State_ref s = --states().end();
+				count_memory(sizeof(State) + a.bytes_reserved() - reserved);
 
 				// make sure we didn't screw up...
 				auto njobs = s->number_of_scheduled_jobs();
@@ -417,6 +957,112 @@ namespace NP
 			{
 				assert(--states().end() == s);
 				states().pop_back();
+				next_front_bytes.bytes -= sizeof(State);
+			}
+
+			void count_memory(std::size_t bytes)
+			{
+				auto next = next_front_bytes.bytes += bytes;
+				if (memory_budget && front_bytes + next > memory_budget)
+				{
+					aborted = true;
+					out_of_memory = true;
+				}
+			}
+
+			void trace_edge(const State &source, const State &target,
+							Job_index j, const Interval<Time> &finish_range)
+			{
+				if (!trace)
+					return;
+#ifdef CONFIG_PARALLEL
+				trace_edges.local().push_back(
+					Trace_edge{&source, &target, j, finish_range});
+#else
+				trace_edges.push_back(
+					Trace_edge{&source, &target, j, finish_range});
+#endif
+			}
+
+			// streams the states of the last depth, and the edges into them,
+			// to the trace; both are sorted by their contents first, so
+			// that the numbers of the states do not depend on which worker
+			// thread found them. States with the same contents (unmerged,
+			// e.g., in the naive exploration) are ordered by their first
+			// incoming edge. Once aborted, how much of the last depth was
+			// explored still depends on the timing of the threads.
+			void trace_depth()
+			{
+				std::vector<const State *> new_states;
+				std::vector<Trace_edge> new_edges;
+#ifdef CONFIG_PARALLEL
+				for (const States &part : states_storage.back())
+					for (const State &s : part)
+						new_states.push_back(&s);
+				for (auto &part : trace_edges) {
+					new_edges.insert(new_edges.end(), part.begin(), part.end());
+					part.clear();
+				}
+#else
+				for (const State &s : states_storage.back())
+					new_states.push_back(&s);
+				new_edges.swap(trace_edges);
+#endif
+				typedef std::tuple<std::uint64_t, Job_index, Time, Time>
+					Edge_key;
+				std::unordered_map<const State *, Edge_key> first_edge;
+				for (const Trace_edge &e : new_edges) {
+					Edge_key key{trace_ids.at(e.source), e.job,
+					             e.finish_range.from(),
+					             e.finish_range.until()};
+					auto found = first_edge.emplace(e.target, key);
+					if (!found.second && key < found.first->second)
+						found.first->second = key;
+				}
+				std::sort(new_states.begin(), new_states.end(),
+				          [&](const State *a, const State *b)
+				          {
+					          if (a->precedes(*b))
+						          return true;
+					          if (b->precedes(*a))
+						          return false;
+					          return first_edge[a] < first_edge[b];
+				          });
+
+				trace->begin_depth(current_job_count, new_states.size(),
+								   new_edges.size());
+
+				std::unordered_map<const State *, std::uint64_t> ids;
+				for (const State *s : new_states) {
+					ids.emplace(s, trace->number_of_states());
+					trace->global_state(s->core_availabilities(),
+										s->certainly_running_jobs());
+				}
+
+				auto edge_key = [&](const Trace_edge &e)
+				{
+					return std::make_tuple(
+						trace_ids.at(e.source), ids.at(e.target), e.job,
+						e.finish_range.from(), e.finish_range.until());
+				};
+				std::sort(new_edges.begin(), new_edges.end(),
+				          [&](const Trace_edge &a, const Trace_edge &b)
+				          { return edge_key(a) < edge_key(b); });
+				for (const Trace_edge &e : new_edges)
+					trace->edge(trace_ids.at(e.source), ids.at(e.target),
+								e.job, e.finish_range);
+
+				trace->end_depth();
+				trace_ids.swap(ids);
+			}
+
+			// the depth being built becomes the exploration front
+			void advance_front()
+			{
+				peak_frontier_bytes = std::max(
+					peak_frontier_bytes, front_bytes + next_front_bytes.bytes);
+				front_bytes = next_front_bytes.bytes;
+				next_front_bytes.bytes = 0;
 			}
 
 			template <typename... Args>
@@ -428,6 +1074,7 @@ namespace NP
 			template <typename... Args>
 			State &new_or_merged_state(Args &&...args)
 			{
+				auto arena_mark = arena().mark();
 				State_ref s_ref = alloc_state(std::forward<Args>(args)...);
 
 				// try to merge the new state into an existing state
@@ -435,82 +1082,61 @@ namespace NP
 				if (s != s_ref)
 				{
 					// great, we merged!
-					// clean up the just-created state that we no longer need
+					// clean up the just-created state that we no longer need,
+					// and reuse its payload memory, the last one allocated
+					// by this thread
 					dealloc_state(s_ref);
+					arena().release(arena_mark);
 				}
 				return *s;
 			}
 
-#ifdef CONFIG_PARALLEL
-
-			// make state available for fast lookup
-			void insert_cache_state(States_map_accessor &acc, State_ref s)
-			{
-				assert(!acc.empty());
-
-				State_refs &list = acc->second;
-				list.push_front(s);
-			}
-
-			// returns true if state was merged
+			// returns the state s was merged into, or s if it was cached
 			State_ref merge_or_cache(State_ref s)
 			{
-				States_map_accessor acc;
-
-				while (true)
-				{
-					// check if key exists
-					if (states_by_key.find(acc, s->get_key()))
+#ifdef CONFIG_PARALLEL
+				Merge_counters &counters = merge_counters.local();
+#else
+				Merge_counters &counters = merge_counters;
+#endif
+				return states_by_key.with_value(
+					s->get_key(),
+					[&](State_refs &list) -> State_ref
 					{
-						for (State_ref other : acc->second)
+						for (State_ref other : list)
+						{
+							counters.candidates++;
 							if (other->try_to_merge(*s))
 								return other;
+							if (!other->same_jobs_scheduled(*s))
+								counters.collisions++;
+						}
 						// If we reach here, we failed to merge, so go ahead
-						// and insert it.
-						insert_cache_state(acc, s);
-						return s;
-						// otherwise, key doesn't exist yet, let's try to create it
-					}
-					else if (states_by_key.insert(acc, s->get_key()))
-					{
-						// We created the list, so go ahead and insert our state.
-						insert_cache_state(acc, s);
+						// and make the state available for fast lookup.
+						list.push_front(s);
 						return s;
-					}
-					// if we raced with concurrent creation, try again
-				}
+					});
 			}
 
-#else
-
-			void cache_state(State_ref s)
+			void collect_hash_statistics()
 			{
-				// create a new list if needed, or lookup if already existing
-				auto res = states_by_key.emplace(
-					std::make_pair(s->get_key(), State_refs()));
-
-				auto pair_it = res.first;
-				State_refs &list = pair_it->second;
-
-				list.push_front(s);
-			}
-
-			State_ref merge_or_cache(State_ref s_ref)
-			{
-				State &s = *s_ref;
-
-				const auto pair_it = states_by_key.find(s.get_key());
-
-				// cannot merge if key doesn't exist
-				if (pair_it != states_by_key.end())
-					for (State_ref other : pair_it->second)
-						if (other->try_to_merge(*s_ref))
-							return other;
-				// if we reach here, we failed to merge
-				cache_state(s_ref);
-				return s_ref;
-			}
+				auto table = states_by_key.statistics();
+				hash_stats.lookups = table.lookups;
+				hash_stats.probes = table.probes;
+				hash_stats.max_probe = table.max_probe;
+#ifdef CONFIG_PARALLEL
+				hash_stats.candidates = 0;
+				hash_stats.collisions = 0;
+				for (const auto &c : merge_counters)
+				{
+					hash_stats.candidates += c.candidates;
+					hash_stats.collisions += c.collisions;
+				}
+#else
+				hash_stats.candidates = merge_counters.candidates;
+				hash_stats.collisions = merge_counters.collisions;
 #endif
+			}
 
 			void check_cpu_timeout()
 			{
@@ -550,7 +1176,7 @@ namespace NP
 				{
 					Interval<Time> ft{0, 0};
 					if (!s.get_finish_times(pred, ft))
-						ft = get_finish_times(jobs[pred]);
+						ft = finish_times_of(pred);
 					r.lower_bound(ft.min());
 					r.extend_to(ft.max());
 				}
@@ -570,7 +1196,7 @@ namespace NP
 						continue;
 					Interval<Time> ft{0, 0};
 					if (!s.get_finish_times(pred, ft))
-						ft = get_finish_times(jobs[pred]);
+						ft = finish_times_of(pred);
 					r.lower_bound(ft.min());
 					r.extend_to(ft.max());
 				}
@@ -729,6 +1355,7 @@ namespace NP
 #ifdef CONFIG_COLLECT_SCHEDULE_GRAPH
 				edges.emplace_back(&j, &s, &next, ftimes);
 #endif
+				trace_edge(s, next, index_of(j), ftimes);
 				count_edge();
 
 				return true;
@@ -738,6 +1365,11 @@ namespace NP
 			{
 				bool found_one = false;
 
+				// stop growing the next depth once it is out of budget, or
+				// once a deadline miss settled the schedulability
+				if (out_of_memory || (aborted && schedulability_only))
+					return;
+
 				DM("----" << std::endl);
 
 				// (0) define the window of interest
@@ -752,6 +1384,12 @@ namespace NP
 				// certainly schedules some job
 				auto t_wc = std::max(t_core, t_job);
 
+				// what the checkpoints of the next depths depend on
+				if (checkpoint_stride)
+					note_horizon(window_just_passed(s, t_min)
+									 ? Time_model::constants<Time>::infinity()
+									 : t_wc);
+
 				DM(s << std::endl);
 				DM("t_min: " << t_min << std::endl
 							 << "t_job: " << t_job << std::endl
@@ -761,7 +1399,8 @@ namespace NP
 				DM("==== [1] ====" << std::endl);
 				// (1) first check jobs that may be already pending
 				for (const Job<Time> &j : jobs_by_win.lookup(t_min))
-					if (j.earliest_arrival() <= t_min && ready(s, j))
+					if (j.earliest_arrival() <= t_min && ready(s, j) &&
+						canonical(s, j))
 						found_one |= dispatch(s, j, t_wc);
 
 				DM("==== [2] ====" << std::endl);
@@ -780,6 +1419,10 @@ namespace NP
 					if (!ready(s, j))
 						continue;
 
+					// an interchangeable job is dispatched instead
+					if (!canonical(s, j))
+						continue;
+
 					// Since this job is released in the future, it better
 					// be incomplete...
 					assert(unfinished(s, j));
@@ -802,10 +1445,16 @@ namespace NP
 
 			void explore()
 			{
-				make_initial_state();
+				// unless resumed from a checkpoint
+				if (states_storage.empty())
+					make_initial_state();
+				if (trace)
+					trace_depth();
 
 				while (current_job_count < jobs.size())
 				{
+					advance_front();
+
 					unsigned long n;
 #ifdef CONFIG_PARALLEL
 					const auto &new_states_part = states_storage.back();
@@ -819,8 +1468,15 @@ namespace NP
 					n = exploration_front.size();
 #endif
 
+					if (checkpoint_stride && !aborted && current_job_count &&
+						current_job_count % checkpoint_stride == 0 &&
+						(checkpoints.empty() ||
+						 checkpoints.checkpoints.back().depth < current_job_count))
+						keep_checkpoint();
+
 					// allocate states space for next depth
 					states_storage.emplace_back();
+					arenas_storage.emplace_back();
 
 					// keep track of exploration front width
 					width = std::max(width, n);
@@ -866,12 +1522,12 @@ namespace NP
 
 					current_job_count++;
 
-#ifdef CONFIG_PARALLEL
 					// propagate any updates to the response-time estimates
-					for (auto &r : partial_rta)
-						for (const auto &elem : r)
-							update_finish_times(rta, elem.first, elem.second);
-#endif
+					rta.merge();
+					if (checkpoint_stride)
+						fold_horizon();
+					if (trace)
+						trace_depth();
 
 #ifndef CONFIG_COLLECT_SCHEDULE_GRAPH
 							// If we don't need to collect all states, we can remove
@@ -886,10 +1542,15 @@ namespace NP
 								 });
 #endif
 					states_storage.pop_front();
+					// free the payloads of the whole depth at once
+					arenas_storage.pop_front();
 #endif
 				}
 
 #ifndef CONFIG_COLLECT_SCHEDULE_GRAPH
+				peak_frontier_bytes = std::max(
+					peak_frontier_bytes, front_bytes + next_front_bytes.bytes);
+
 				// clean out any remaining states
 				while (!states_storage.empty())
 				{
@@ -902,6 +1563,7 @@ namespace NP
 								 });
 #endif
 					states_storage.pop_front();
+					arenas_storage.pop_front();
 				}
 #endif
 
@@ -909,11 +1571,12 @@ namespace NP
 				for (auto &c : edge_counter)
 					num_edges += c;
 #endif
+				collect_hash_statistics();
 			}
 
 #ifdef CONFIG_COLLECT_SCHEDULE_GRAPH
 			friend std::ostream &operator<<(std::ostream &out,
-											const State_space<Time> &space)
+											const State_space<Time, Response_times> &space)
 			{
 				std::map<const Schedule_state<Time> *, unsigned int> state_id;
 				unsigned int i = 0;
@@ -971,6 +1634,9 @@ namespace NP
 #endif
 		};
 
+		template <class Time, class Response_times>
+		constexpr Job_index State_space<Time, Response_times>::no_job;
+
 	}
 }
 
@@ -1,3 +1,6 @@
+#ifndef GLOBAL_STATE_HPP
+#define GLOBAL_STATE_HPP
+
 #include <iostream>
 #include <ostream>
 #include <cassert>
@@ -6,6 +9,7 @@
 #include <set>
 
 #include "util.hpp"
+#include "arena.hpp"
 #include "index_set.hpp"
 #include "jobs.hpp"
 #include "cache.hpp"
@@ -24,22 +28,26 @@ namespace NP
 		{
 		public:
 			// initial state -- nothing yet has finished, nothing is running
-			Schedule_state(unsigned int num_processors)
-				: num_jobs_scheduled(0), scheduled_jobs(), core_avail{num_processors, Interval<Time>(Time(0), Time(0))}, lookup_key{0x9a9a9a9a9a9a9a9aUL}
+			Schedule_state(unsigned int num_processors,
+						   Bump_arena *arena = nullptr)
+				: num_jobs_scheduled(0), scheduled_jobs(), certain_jobs(arena), core_avail(num_processors, Interval<Time>(Time(0), Time(0)), arena), lookup_key{0x9a9a9a9a9a9a9a9aUL}
 			{
 				assert(core_avail.size() > 0);
 			}
 
 			// transition: new state by scheduling a job in an existing state,
 			//             by replacing a given running job.
+			// If an arena is given, all the payload of the state is allocated
+			// from it, and is freed only together with the arena.
 			Schedule_state(
 				const Schedule_state &from,
 				Job_index j,
 				const Job_precedence_set &predecessors,
 				Interval<Time> start_times,
 				Interval<Time> finish_times,
-				hash_value_t key)
-				: num_jobs_scheduled(from.num_jobs_scheduled + 1), scheduled_jobs{from.scheduled_jobs, j}, lookup_key{from.lookup_key ^ key}
+				hash_value_t key,
+				Bump_arena *arena = nullptr)
+				: num_jobs_scheduled(from.num_jobs_scheduled + 1), scheduled_jobs{from.scheduled_jobs, j, arena}, certain_jobs(arena), core_avail(arena), lookup_key{from.lookup_key ^ key}
 			{
 				auto est = start_times.min();
 				auto lst = start_times.max();
@@ -65,6 +73,7 @@ namespace NP
 
 				// update scheduled jobs
 				// keep it sorted to make it easier to merge
+				certain_jobs.reserve(from.certain_jobs.size() + 1);
 				bool added_j = false;
 				for (const auto &rj : from.certain_jobs)
 				{
@@ -99,6 +108,7 @@ namespace NP
 				std::sort(pa.begin(), pa.end());
 				std::sort(ca.begin(), ca.end());
 
+				core_avail.reserve(from.core_avail.size());
 				for (size_t i = 0; i < from.core_avail.size(); i++)
 				{
 					DM(i << " -> " << pa[i] << ":" << ca[i] << std::endl);
@@ -109,6 +119,26 @@ namespace NP
 				DM("*** new state: constructed " << *this << std::endl);
 			}
 
+			// the same state, for a workload in which job i of the workload
+			// of `from` has index index_map[i] and its key changed by
+			// key_change[i] (if key_change is not empty)
+			Schedule_state(
+				const Schedule_state &from,
+				const std::vector<Job_index> &index_map,
+				const std::vector<hash_value_t> &key_change,
+				Bump_arena *arena = nullptr)
+				: num_jobs_scheduled(from.num_jobs_scheduled), scheduled_jobs{from.scheduled_jobs, index_map, arena}, certain_jobs(arena), core_avail(arena), lookup_key{changed_key(from, key_change)}
+			{
+				certain_jobs.reserve(from.certain_jobs.size());
+				for (const auto &rj : from.certain_jobs)
+					certain_jobs.emplace_back(index_map[rj.first], rj.second);
+				// keep it sorted by index
+				std::sort(certain_jobs.begin(), certain_jobs.end(),
+						  [](const Certain_job &a, const Certain_job &b)
+						  { return a.first < b.first; });
+				core_avail.assign(from.core_avail.begin(), from.core_avail.end());
+			}
+
 			hash_value_t get_key() const
 			{
 				return lookup_key;
@@ -119,6 +149,43 @@ namespace NP
 				return scheduled_jobs == other.scheduled_jobs;
 			}
 
+			// an order of the states that depends only on their contents,
+			// not on how they were found (e.g., to number them in traces)
+			bool precedes(const Schedule_state &other) const
+			{
+				auto interval_less = [](const Interval<Time> &a,
+				                        const Interval<Time> &b)
+				{
+					return a.from() < b.from()
+					       || (a.from() == b.from() && a.until() < b.until());
+				};
+				auto job_less = [&](const Certain_job &a, const Certain_job &b)
+				{
+					return a.first < b.first
+					       || (a.first == b.first
+					           && interval_less(a.second, b.second));
+				};
+				if (std::lexicographical_compare(
+						core_avail.begin(), core_avail.end(),
+						other.core_avail.begin(), other.core_avail.end(),
+						interval_less))
+					return true;
+				if (std::lexicographical_compare(
+						other.core_avail.begin(), other.core_avail.end(),
+						core_avail.begin(), core_avail.end(), interval_less))
+					return false;
+				if (std::lexicographical_compare(
+						certain_jobs.begin(), certain_jobs.end(),
+						other.certain_jobs.begin(), other.certain_jobs.end(),
+						job_less))
+					return true;
+				if (std::lexicographical_compare(
+						other.certain_jobs.begin(), other.certain_jobs.end(),
+						certain_jobs.begin(), certain_jobs.end(), job_less))
+					return false;
+				return scheduled_jobs < other.scheduled_jobs;
+			}
+
 			bool can_merge_with(const Schedule_state<Time> &other) const
 			{
 				assert(core_avail.size() == other.core_avail.size());
@@ -141,10 +208,11 @@ namespace NP
 				for (size_t i = 0; i < core_avail.size(); i++)
 					core_avail[i] |= other.core_avail[i];
 
-				// vector to collect joint certain jobs
-				std::vector<std::pair<Job_index, Interval<Time>>> new_cj;
-
-				// walk both sorted job lists to see if we find matches
+				// walk both sorted job lists to see if we find matches; the
+				// joint certain jobs are a subsequence of certain_jobs, so
+				// they are collected in place without allocating (the
+				// payload of this state may live in another thread's arena)
+				auto out = certain_jobs.begin();
 				auto it = certain_jobs.begin();
 				auto jt = other.certain_jobs.begin();
 				while (it != certain_jobs.end() &&
@@ -153,7 +221,7 @@ namespace NP
 					if (it->first == jt->first)
 					{
 						// same job
-						new_cj.emplace_back(it->first, it->second | jt->second);
+						*out++ = std::make_pair(it->first, it->second | jt->second);
 						it++;
 						jt++;
 					}
@@ -162,8 +230,7 @@ namespace NP
 					else
 						jt++;
 				}
-				// move new certain jobs into the state
-				certain_jobs.swap(new_cj);
+				certain_jobs.erase(out, certain_jobs.end());
 
 				DM("+++ merged " << other << " into " << *this << std::endl);
 
@@ -248,6 +315,21 @@ namespace NP
 				out << "}";
 			}
 
+			typedef std::pair<Job_index, Interval<Time>> Certain_job;
+			typedef std::vector<Certain_job, Arena_allocator<Certain_job>> Certain_jobs;
+			typedef std::vector<Interval<Time>, Arena_allocator<Interval<Time>>> Core_availability;
+
+			// for schedule-graph traces (see trace.hpp)
+			const Core_availability &core_availabilities() const
+			{
+				return core_avail;
+			}
+
+			const Certain_jobs &certainly_running_jobs() const
+			{
+				return certain_jobs;
+			}
+
 		private:
 			const unsigned int num_jobs_scheduled;
 
@@ -255,16 +337,29 @@ namespace NP
 			const Index_set scheduled_jobs;
 
 			// imprecise set of certainly running jobs
-			std::vector<std::pair<Job_index, Interval<Time>>> certain_jobs;
+			Certain_jobs certain_jobs;
 
 			// system availability intervals
-			std::vector<Interval<Time>> core_avail;
+			Core_availability core_avail;
 
 			const hash_value_t lookup_key;
 
+			static hash_value_t changed_key(
+				const Schedule_state &from,
+				const std::vector<hash_value_t> &key_change)
+			{
+				hash_value_t key = from.lookup_key;
+				if (!key_change.empty())
+					from.scheduled_jobs.for_each([&](Job_index j)
+												 { key ^= key_change[j]; });
+				return key;
+			}
+
 			// no accidental copies
 			Schedule_state(const Schedule_state &origin) = delete;
 		};
 
 	}
 }
+
+#endif
@@ -1,47 +1,127 @@
 #ifndef INDEX_SET_H
 #define INDEX_SET_H
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <vector>
+
+#include "arena.hpp"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 namespace NP
 {
 
+	// Set of small indices (e.g., of the jobs scheduled in a state), packed
+	// into 64-bit words. Sets with up to INLINE_WORDS * 64 indices do not
+	// allocate; larger ones keep their words on the heap, or in the arena
+	// they were derived with.
 	class Index_set
 	{
 	public:
-		typedef std::vector<bool> Set_type;
+		typedef std::uint64_t Word;
+
+		static const std::size_t BITS_PER_WORD = 64;
+		static const std::size_t INLINE_WORDS = 2;
 
 		// new empty job set
-		Index_set() : the_set() {}
+		Index_set() : num_words(INLINE_WORDS), words(inline_words)
+		{
+			std::fill(inline_words, inline_words + INLINE_WORDS, Word(0));
+		}
 
 		// derive a new set by "cloning" an existing set and adding an index
-		Index_set(const Index_set &from, std::size_t idx)
-			: the_set(std::max(from.the_set.size(), idx + 1))
+		Index_set(const Index_set &from, std::size_t idx,
+				  Bump_arena *arena = nullptr)
+			: num_words(std::max(from.num_words, word_of(idx) + 1)),
+			  alloc(arena), words(allocate(num_words))
 		{
-			std::copy(from.the_set.begin(), from.the_set.end(), the_set.begin());
-			the_set[idx] = true;
+			std::memcpy(words, from.words, from.num_words * sizeof(Word));
+			std::fill(words + from.num_words, words + num_words, Word(0));
+			words[word_of(idx)] |= bit_of(idx);
+		}
+
+		// the image of a set under a map of its indices (e.g., from the
+		// jobs of one workload to those of a changed workload)
+		Index_set(const Index_set &from,
+				  const std::vector<std::size_t> &index_map,
+				  Bump_arena *arena = nullptr)
+			: num_words(image_words(from, index_map)),
+			  alloc(arena), words(allocate(num_words))
+		{
+			std::fill(words, words + num_words, Word(0));
+			from.for_each([&](std::size_t idx)
+						  { words[word_of(index_map[idx])] |=
+								bit_of(index_map[idx]); });
 		}
 
 		// create the diff of two job sets (intended for debugging only)
 		Index_set(const Index_set &a, const Index_set &b)
-			: the_set(std::max(a.the_set.size(), b.the_set.size()), true)
+			: num_words(std::max(a.num_words, b.num_words)),
+			  words(allocate(num_words))
+		{
+			for (std::size_t i = 0; i < num_words; i++)
+				words[i] = a.word(i) ^ b.word(i);
+		}
+
+		~Index_set()
 		{
-			auto limit = std::min(a.the_set.size(), b.the_set.size());
-			for (unsigned int i = 0; i < limit; i++)
-				the_set[i] = a.contains(i) ^ b.contains(i);
+			if (words != inline_words)
+				alloc.deallocate(words, num_words);
 		}
 
 		bool operator==(const Index_set &other) const
 		{
-			return the_set == other.the_set;
+			auto limit = std::min(num_words, other.num_words);
+			return equal_words(words, other.words, limit) &&
+				   all_zero(words + limit, num_words - limit) &&
+				   all_zero(other.words + limit, other.num_words - limit);
 		}
 
 		bool operator!=(const Index_set &other) const
 		{
-			return the_set != other.the_set;
+			return !(*this == other);
+		}
+
+		// a fixed total order of the sets, consistent with ==
+		bool operator<(const Index_set &other) const
+		{
+			auto n = std::max(num_words, other.num_words);
+			for (std::size_t i = 0; i < n; i++)
+				if (word(i) != other.word(i))
+					return word(i) < other.word(i);
+			return false;
+		}
+
+		// whether this set with idx added equals other with other_idx
+		// added, without deriving either of them
+		bool equals_with(std::size_t idx, const Index_set &other,
+						 std::size_t other_idx) const
+		{
+			if (idx == other_idx && !contains(idx) && !other.contains(idx))
+				return *this == other;
+			auto n = std::max(std::max(num_words, other.num_words),
+							  word_of(std::max(idx, other_idx)) + 1);
+			for (std::size_t i = 0; i < n; i++)
+			{
+				Word a = word(i), b = other.word(i);
+				if (i == word_of(idx))
+					a |= bit_of(idx);
+				if (i == word_of(other_idx))
+					b |= bit_of(other_idx);
+				if (a != b)
+					return false;
+			}
+			return true;
 		}
 
 		bool contains(std::size_t idx) const
 		{
-			return the_set.size() > idx && the_set[idx];
+			return word(word_of(idx)) & bit_of(idx);
 		}
 
 		bool includes(std::vector<std::size_t> indices) const
@@ -54,26 +134,49 @@ namespace NP
 
 		bool is_subset_of(const Index_set &other) const
 		{
-			for (unsigned int i = 0; i < the_set.size(); i++)
-				if (contains(i) && !other.contains(i))
-					return false;
-			return true;
+			auto limit = std::min(num_words, other.num_words);
+			return subset_words(words, other.words, limit) &&
+				   all_zero(words + limit, num_words - limit);
 		}
 
 		std::size_t size() const
 		{
 			std::size_t count = 0;
-			for (auto x : the_set)
-				if (x)
-					count++;
+			for (std::size_t i = 0; i < num_words; i++)
+				count += __builtin_popcountll(words[i]);
 			return count;
 		}
 
 		void add(std::size_t idx)
 		{
-			if (idx >= the_set.size())
-				the_set.resize(idx + 1);
-			the_set[idx] = true;
+			if (word_of(idx) >= num_words)
+				grow(word_of(idx) + 1);
+			words[word_of(idx)] |= bit_of(idx);
+		}
+
+		// calls f(idx) for every index in the set, in increasing order
+		template <class F>
+		void for_each(F f) const
+		{
+			for (std::size_t i = 0; i < num_words; i++)
+				for (Word w = words[i]; w; w &= w - 1)
+					f(i * BITS_PER_WORD + __builtin_ctzll(w));
+		}
+
+		// hash of the contents; equal sets have equal hashes regardless of
+		// how many words they occupy
+		std::size_t hash() const
+		{
+			std::uint64_t h = 0x9a9a9a9a9a9a9a9aULL;
+			for (std::size_t i = 0; i < num_words; i++)
+				if (words[i])
+				{
+					std::uint64_t x = words[i] ^ (i * 0x9e3779b97f4a7c15ULL);
+					x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+					x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+					h ^= x ^ (x >> 31);
+				}
+			return h;
 		}
 
 		friend std::ostream &operator<<(std::ostream &stream,
@@ -81,8 +184,8 @@ namespace NP
 		{
 			bool first = true;
 			stream << "{";
-			for (size_t i = 0; i < s.the_set.size(); i++)
-				if (s.the_set[i])
+			for (size_t i = 0; i < s.num_words * BITS_PER_WORD; i++)
+				if (s.contains(i))
 				{
 					if (!first)
 						stream << ", ";
@@ -95,10 +198,104 @@ namespace NP
 		}
 
 	private:
-		Set_type the_set;
+		std::size_t num_words;
+		Arena_allocator<Word> alloc;
+		Word *words;
+		Word inline_words[INLINE_WORDS];
 
 		// no accidental copies
 		Index_set(const Index_set &origin) = delete;
+		Index_set &operator=(const Index_set &origin) = delete;
+
+		static std::size_t word_of(std::size_t idx)
+		{
+			return idx / BITS_PER_WORD;
+		}
+
+		static Word bit_of(std::size_t idx)
+		{
+			return Word(1) << (idx % BITS_PER_WORD);
+		}
+
+		Word word(std::size_t i) const
+		{
+			return i < num_words ? words[i] : Word(0);
+		}
+
+		static std::size_t image_words(const Index_set &from,
+									   const std::vector<std::size_t> &index_map)
+		{
+			std::size_t n = INLINE_WORDS;
+			from.for_each([&](std::size_t idx)
+						  { n = std::max(n, word_of(index_map[idx]) + 1); });
+			return n;
+		}
+
+		Word *allocate(std::size_t n)
+		{
+			return n <= INLINE_WORDS ? inline_words : alloc.allocate(n);
+		}
+
+		void grow(std::size_t n)
+		{
+			// double the capacity, so that adding indices one by one is
+			// amortized constant time
+			n = std::max(n, 2 * num_words);
+			Word *grown = alloc.allocate(n);
+			std::memcpy(grown, words, num_words * sizeof(Word));
+			std::fill(grown + num_words, grown + n, Word(0));
+			if (words != inline_words)
+				alloc.deallocate(words, num_words);
+			words = grown;
+			num_words = n;
+		}
+
+		static bool all_zero(const Word *a, std::size_t n)
+		{
+			for (std::size_t i = 0; i < n; i++)
+				if (a[i])
+					return false;
+			return true;
+		}
+
+		static bool equal_words(const Word *a, const Word *b, std::size_t n)
+		{
+			std::size_t i = 0;
+#ifdef __AVX2__
+			for (; i + 4 <= n; i += 4)
+			{
+				__m256i x = _mm256_loadu_si256((const __m256i *)(a + i));
+				__m256i y = _mm256_loadu_si256((const __m256i *)(b + i));
+				__m256i diff = _mm256_xor_si256(x, y);
+				if (!_mm256_testz_si256(diff, diff))
+					return false;
+			}
+#endif
+			for (; i < n; i++)
+				if (a[i] != b[i])
+					return false;
+			return true;
+		}
+
+		// whether every bit of a is also set in b
+		static bool subset_words(const Word *a, const Word *b, std::size_t n)
+		{
+			std::size_t i = 0;
+#ifdef __AVX2__
+			for (; i + 4 <= n; i += 4)
+			{
+				__m256i x = _mm256_loadu_si256((const __m256i *)(a + i));
+				__m256i y = _mm256_loadu_si256((const __m256i *)(b + i));
+				// testc(y, x) is set iff (~y & x) == 0
+				if (!_mm256_testc_si256(y, x))
+					return false;
+			}
+#endif
+			for (; i < n; i++)
+				if (a[i] & ~b[i])
+					return false;
+			return true;
+		}
 	};
 }
 
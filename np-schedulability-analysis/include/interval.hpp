@@ -5,6 +5,8 @@
 #include <ostream>
 #include <memory>
 #include <vector>
+#include <functional>
+#include <algorithm>
 #include <ciso646>
 
 template<class T> class Interval {
@@ -34,6 +36,8 @@ template<class T> class Interval {
 	{
 	}
 
+	Interval<T>& operator=(const Interval<T>& orig) = default;
+
 	const T& from() const
 	{
 		return a;
@@ -206,4 +210,108 @@ template<class T, class X, Interval<T> (*map)(const X&)> class Interval_lookup_t
 
 };
 
+// A read-only Interval_lookup_table with the same buckets, stored back to
+// back in one array and built in one go, rather than one vector per bucket.
+template<class T, class X, Interval<T> (*map)(const X&)> class Interval_lookup_array {
+	typedef std::reference_wrapper<const X> Entry;
+
+	public:
+
+	class Bucket {
+		const Entry *first, *last;
+
+		public:
+
+		Bucket(const Entry *first, const Entry *last)
+		: first(first), last(last)
+		{
+		}
+
+		const Entry *begin() const
+		{
+			return first;
+		}
+
+		const Entry *end() const
+		{
+			return last;
+		}
+
+		std::size_t size() const
+		{
+			return last - first;
+		}
+	};
+
+	private:
+
+	Interval<T> range;
+	T width;
+	std::size_t num_buckets;
+	// bucket i holds entries[offsets[i]] up to entries[offsets[i + 1]]
+	std::vector<std::size_t> offsets;
+	std::vector<Entry> entries;
+
+	public:
+
+	std::size_t bucket_of(const T& point) const
+	{
+		if (range.contains(point)) {
+			return static_cast<std::size_t>((point - range.from()) / width);
+		} else if (point < range.from()) {
+			return 0;
+		} else
+			return num_buckets - 1;
+	}
+
+	// adds the items in the order of the container, as if they were
+	// inserted one by one into an Interval_lookup_table
+	template<class Items>
+	Interval_lookup_array(const Interval<T>& range, T bucket_width,
+	                      const Items& items)
+	: range(range)
+	, width(std::max(bucket_width, static_cast<T>(1)))
+	, num_buckets(1 + std::max(
+	                  static_cast<std::size_t>(range.length() / this->width),
+	                  static_cast<std::size_t>(1)))
+	, offsets(num_buckets + 1, 0)
+	{
+		// count the entries of each bucket...
+		for (const X& x : items) {
+			Interval<T> w = map(x);
+			auto a = bucket_of(w.from()), b = bucket_of(w.until());
+			assert(a < num_buckets);
+			assert(b < num_buckets);
+			for (auto i = a; i <= b; i++)
+				offsets[i + 1]++;
+		}
+		for (std::size_t i = 0; i < num_buckets; i++)
+			offsets[i + 1] += offsets[i];
+
+		// ...and fill them in
+		std::vector<std::size_t> fill(offsets.begin(), offsets.end() - 1);
+		// (reference wrappers have no default, so start with any item)
+		if (offsets.back() > 0)
+			entries.assign(offsets.back(), std::cref(*std::begin(items)));
+		for (const X& x : items) {
+			Interval<T> w = map(x);
+			auto a = bucket_of(w.from()), b = bucket_of(w.until());
+			for (auto i = a; i <= b; i++)
+				entries[fill[i]++] = x;
+		}
+	}
+
+	Bucket lookup(T point) const
+	{
+		return bucket(bucket_of(point));
+	}
+
+	Bucket bucket(std::size_t i) const
+	{
+		return Bucket(entries.data() + offsets[i],
+		              entries.data() + offsets[i + 1]);
+	}
+
+};
+
 #endif
@@ -1,7 +1,13 @@
 #ifndef IO_HPP
 #define IO_HPP
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <string>
+#include <type_traits>
 #include <utility>
 
 #include "interval.hpp"
@@ -194,6 +200,284 @@ namespace NP {
 	}
 
 
+	// Scans CSV text in place, e.g., the contents of a Mapped_file. It
+	// accepts what the stream parsers above accept: fields separated by
+	// blanks and at most one comma, rows by line breaks. Like them, it
+	// throws std::ios_base::failure on malformed input.
+	class Csv_cursor
+	{
+		public:
+
+		Csv_cursor(const char *begin, const char *end)
+		: pos(begin), end(end)
+		{
+		}
+
+		void next_line()
+		{
+			auto eol = static_cast<const char *>(
+				std::memchr(pos, '\n', end - pos));
+			pos = eol ? eol + 1 : end;
+		}
+
+		// skips blank lines; false at the end of the text
+		bool more_data()
+		{
+			while (true) {
+				skip_blanks();
+				if (pos == end)
+					return false;
+				if (*pos != '\n')
+					return true;
+				pos++;
+			}
+		}
+
+		// the next field, which must be on the current line
+		template<class T> T field()
+		{
+			T value;
+			skip_blanks();
+			parse(value, std::is_integral<T>());
+			skip_blanks();
+			if (pos != end && *pos == ',')
+				pos++;
+			return value;
+		}
+
+		private:
+
+		const char *pos, *end;
+
+		void skip_blanks()
+		{
+			while (pos != end && (*pos == ' ' || *pos == '\t' || *pos == '\r'))
+				pos++;
+		}
+
+		static bool is_digit(char c)
+		{
+			return (unsigned char) (c - '0') < 10;
+		}
+
+		static void fail()
+		{
+			throw std::ios_base::failure("malformed number");
+		}
+
+		template<class T> void parse(T &value, std::true_type)
+		{
+			bool negative = std::is_signed<T>::value && pos != end
+			                && *pos == '-';
+			if (negative)
+				pos++;
+			const char *digits = pos;
+			T v = 0;
+			while (pos != end && is_digit(*pos))
+				v = 10 * v + (*pos++ - '0');
+			if (pos == digits)
+				fail();
+			value = negative ? -v : v;
+		}
+
+		template<class T> void parse(T &value, std::false_type)
+		{
+			// strtod() needs a terminated string
+			char number[64];
+			std::size_t n = 0;
+			while (pos != end && n + 1 < sizeof(number)
+			       && (is_digit(*pos) || *pos == '.' || *pos == 'e'
+			           || *pos == 'E' || *pos == '-' || *pos == '+'))
+				number[n++] = *pos++;
+			number[n] = 0;
+			char *stop;
+			value = std::strtod(number, &stop);
+			if (!n || stop != number + n)
+				fail();
+		}
+	};
+
+	inline JobID parse_job_id(Csv_cursor& in)
+	{
+		auto tid = in.field<unsigned long>();
+		auto jid = in.field<unsigned long>();
+		return JobID(jid, tid);
+	}
+
+	inline Precedence_constraint parse_precedence_constraint(Csv_cursor& in)
+	{
+		auto from = parse_job_id(in);
+		auto to = parse_job_id(in);
+		return Precedence_constraint(from, to);
+	}
+
+	// like parse_dag_file(std::istream&), but on text in memory
+	inline Precedence_constraints parse_dag_file(const char *begin,
+	                                             const char *end)
+	{
+		Precedence_constraints edges;
+		Csv_cursor in(begin, end);
+
+		// skip column headers
+		in.next_line();
+
+		while (in.more_data()) {
+			edges.push_back(parse_precedence_constraint(in));
+			in.next_line();
+		}
+
+		return edges;
+	}
+
+	template<class Time> Job<Time> parse_job(Csv_cursor& in)
+	{
+		auto tid = in.field<unsigned long>();
+		auto jid = in.field<unsigned long>();
+		auto arr_min = in.field<Time>();
+		auto arr_max = in.field<Time>();
+		auto cost_min = in.field<Time>();
+		auto cost_max = in.field<Time>();
+		auto dl = in.field<Time>();
+		auto prio = in.field<Time>();
+
+		return Job<Time>{jid, Interval<Time>{arr_min, arr_max},
+						 Interval<Time>{cost_min, cost_max}, dl, prio, tid};
+	}
+
+	// like parse_file(std::istream&), but on text in memory
+	template<class Time>
+	typename Job<Time>::Job_set parse_file(const char *begin, const char *end)
+	{
+		Csv_cursor in(begin, end);
+
+		// first row contains a comment, just skip it
+		in.next_line();
+
+		typename Job<Time>::Job_set jobs;
+		// at most one job per line
+		jobs.reserve(std::count(begin, end, '\n') + 1);
+
+		while (in.more_data()) {
+			jobs.push_back(parse_job<Time>(in));
+			// munge any trailing whitespace or extra columns
+			in.next_line();
+		}
+
+		return jobs;
+	}
+
+	// Binary job sets hold the jobs and the precedence constraints of a
+	// workload in the byte order of the machine that wrote them:
+	//  - a header: the magic bytes below, sizeof(Time) and whether Time is
+	//    integral (one byte each, padded to eight), and the numbers of jobs
+	//    and of constraints (64 bits each);
+	//  - per job: the task and job IDs (64 bits each), and the earliest and
+	//    latest arrival, least and largest cost, deadline and priority (one
+	//    Time each);
+	//  - per constraint: the task and job IDs of the predecessor and of the
+	//    successor (64 bits each).
+	// They load without any parsing (see parse_binary_job_set()).
+	inline const char *binary_job_set_magic()
+	{
+		// not text, so that CSV files are never mistaken for it
+		return "\x89NPJOBS\n";
+	}
+
+	const std::size_t BINARY_JOB_SET_HEADER = 32;
+
+	inline bool is_binary_job_set(const char *begin, const char *end)
+	{
+		return end - begin >= 8
+		       && !std::memcmp(begin, binary_job_set_magic(), 8);
+	}
+
+	// the number of jobs of a binary job set
+	inline std::uint64_t binary_job_set_size(const char *begin,
+	                                         const char *end)
+	{
+		std::uint64_t num_jobs = 0;
+		if (end - begin >= (std::ptrdiff_t) BINARY_JOB_SET_HEADER)
+			std::memcpy(&num_jobs, begin + 16, sizeof(num_jobs));
+		return num_jobs;
+	}
+
+	template<class Time>
+	void write_binary_job_set(std::ostream &out,
+	                          const typename Job<Time>::Job_set &jobs,
+	                          const Precedence_constraints &dag)
+	{
+		char header[BINARY_JOB_SET_HEADER] = {};
+		std::memcpy(header, binary_job_set_magic(), 8);
+		header[8] = sizeof(Time);
+		header[9] = std::is_integral<Time>::value;
+		std::uint64_t counts[2] = {jobs.size(), dag.size()};
+		std::memcpy(header + 16, counts, sizeof(counts));
+		out.write(header, sizeof(header));
+
+		for (const Job<Time> &j : jobs) {
+			std::uint64_t ids[2] = {j.get_task_id(), j.get_job_id()};
+			Time times[6] = {j.earliest_arrival(), j.latest_arrival(),
+			                 j.least_cost(), j.maximal_cost(),
+			                 j.get_deadline(), j.get_priority()};
+			out.write(reinterpret_cast<const char *>(ids), sizeof(ids));
+			out.write(reinterpret_cast<const char *>(times), sizeof(times));
+		}
+
+		for (const Precedence_constraint &e : dag) {
+			std::uint64_t ids[4] = {e.first.task, e.first.job,
+			                        e.second.task, e.second.job};
+			out.write(reinterpret_cast<const char *>(ids), sizeof(ids));
+		}
+	}
+
+	// reads a binary job set written by write_binary_job_set() with the
+	// same Time; throws std::ios_base::failure if it is malformed
+	template<class Time>
+	void parse_binary_job_set(const char *begin, const char *end,
+	                          typename Job<Time>::Job_set &jobs,
+	                          Precedence_constraints &dag)
+	{
+		const std::size_t job_size = 2 * sizeof(std::uint64_t)
+		                             + 6 * sizeof(Time);
+		const std::size_t edge_size = 4 * sizeof(std::uint64_t);
+
+		std::size_t size = end - begin;
+		if (size < BINARY_JOB_SET_HEADER || !is_binary_job_set(begin, end))
+			throw std::ios_base::failure("not a binary job set");
+		if (begin[8] != sizeof(Time)
+		    || (bool) begin[9] != std::is_integral<Time>::value)
+			throw std::ios_base::failure(
+				"binary job set of another time model");
+		std::uint64_t counts[2];
+		std::memcpy(counts, begin + 16, sizeof(counts));
+		if (counts[0] > size / job_size || counts[1] > size / edge_size
+		    || size != BINARY_JOB_SET_HEADER + counts[0] * job_size
+		               + counts[1] * edge_size)
+			throw std::ios_base::failure("truncated binary job set");
+
+		const char *pos = begin + BINARY_JOB_SET_HEADER;
+		jobs.reserve(jobs.size() + counts[0]);
+		for (std::uint64_t i = 0; i < counts[0]; i++, pos += job_size) {
+			std::uint64_t ids[2];
+			Time times[6];
+			std::memcpy(ids, pos, sizeof(ids));
+			std::memcpy(times, pos + sizeof(ids), sizeof(times));
+			jobs.push_back(Job<Time>{ids[1],
+			                         Interval<Time>{times[0], times[1]},
+			                         Interval<Time>{times[2], times[3]},
+			                         times[4], times[5], ids[0]});
+		}
+
+		dag.reserve(dag.size() + counts[1]);
+		for (std::uint64_t i = 0; i < counts[1]; i++, pos += edge_size) {
+			std::uint64_t ids[4];
+			std::memcpy(ids, pos, sizeof(ids));
+			dag.push_back(Precedence_constraint(JobID(ids[1], ids[0]),
+			                                    JobID(ids[3], ids[2])));
+		}
+	}
+
+
 }
 
 #endif
@@ -1,6 +1,7 @@
 #ifndef JOBS_HPP
 #define JOBS_HPP
 
+#include <cstdint>
 #include <ostream>
 #include <vector>
 #include <algorithm> // for find
@@ -48,16 +49,31 @@ namespace NP {
 		JobID id;
 		hash_value_t key;
 
+		// Zobrist-style key: a pseudo-random 64-bit value derived from all
+		// the parameters of the job, so that the XOR of the keys of a set of
+		// jobs (the lookup key of a state) rarely collides, even for the
+		// many similar jobs of periodic workloads
 		void compute_hash() {
 			auto h = std::hash<Time>{};
-			key = h(arrival.from());
-			key = (key << 4) ^ h(id.task);
-			key = (key << 4) ^ h(arrival.until());
-			key = (key << 4) ^ h(cost.from());
-			key = (key << 4) ^ h(deadline);
-			key = (key << 4) ^ h(cost.upto());
-			key = (key << 4) ^ h(id.job);
-			key = (key << 4) ^ h(priority);
+			std::uint64_t k = 0;
+			k = mix(k ^ h(arrival.from()));
+			k = mix(k ^ h(id.task));
+			k = mix(k ^ h(arrival.until()));
+			k = mix(k ^ h(cost.from()));
+			k = mix(k ^ h(deadline));
+			k = mix(k ^ h(cost.upto()));
+			k = mix(k ^ h(id.job));
+			k = mix(k ^ h(priority));
+			key = k;
+		}
+
+		// SplitMix64 step: every input bit affects every output bit
+		static std::uint64_t mix(std::uint64_t x)
+		{
+			x += 0x9e3779b97f4a7c15ULL;
+			x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+			return x ^ (x >> 31);
 		}
 
 	public:
@@ -0,0 +1,139 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace NP {
+
+	// The read-only contents of an input file, mapped into memory where
+	// the platform supports it, so that the parsers can scan them in place
+	// (see io.hpp). Streams that cannot be mapped, such as standard input,
+	// are read into a buffer instead.
+	class Mapped_file
+	{
+		public:
+
+		// an empty file
+		Mapped_file() : mapping(nullptr), length(0)
+		{
+		}
+
+		// throws std::system_error if the file cannot be opened
+		explicit Mapped_file(const std::string &name)
+		: mapping(nullptr), length(0)
+		{
+#ifdef _WIN32
+			std::ifstream in(name, std::ios::in | std::ios::binary);
+			if (!in)
+				throw std::system_error(ENOENT, std::generic_category(),
+				                        name);
+			read_all(in);
+#else
+			int fd = open(name.c_str(), O_RDONLY);
+			if (fd < 0)
+				throw std::system_error(errno, std::generic_category(),
+				                        name);
+			struct stat st;
+			if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+				length = st.st_size;
+				// mmap() rejects empty mappings
+				if (length) {
+					void *p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE,
+					               fd, 0);
+					if (p == MAP_FAILED) {
+						int error = errno;
+						close(fd);
+						throw std::system_error(error,
+						                        std::generic_category(),
+						                        name);
+					}
+					madvise(p, length, MADV_SEQUENTIAL);
+					mapping = static_cast<const char *>(p);
+				}
+				close(fd);
+			} else {
+				// a pipe or the like
+				close(fd);
+				std::ifstream in(name, std::ios::in | std::ios::binary);
+				read_all(in);
+			}
+#endif
+		}
+
+		// reads all of in into a buffer
+		explicit Mapped_file(std::istream &in) : mapping(nullptr), length(0)
+		{
+			read_all(in);
+		}
+
+		Mapped_file(Mapped_file &&other)
+		: mapping(other.mapping), length(other.length),
+		  buffer(std::move(other.buffer))
+		{
+			other.mapping = nullptr;
+			other.length = 0;
+		}
+
+		Mapped_file &operator=(Mapped_file &&other)
+		{
+			std::swap(mapping, other.mapping);
+			std::swap(length, other.length);
+			buffer.swap(other.buffer);
+			return *this;
+		}
+
+		Mapped_file(const Mapped_file &) = delete;
+		Mapped_file &operator=(const Mapped_file &) = delete;
+
+		~Mapped_file()
+		{
+#ifndef _WIN32
+			if (mapping)
+				munmap(const_cast<char *>(mapping), length);
+#endif
+		}
+
+		const char *begin() const
+		{
+			return mapping ? mapping : buffer.data();
+		}
+
+		const char *end() const
+		{
+			return begin() + size();
+		}
+
+		std::size_t size() const
+		{
+			return mapping ? length : buffer.size();
+		}
+
+		private:
+
+		const char *mapping;
+		std::size_t length;
+		std::string buffer;
+
+		void read_all(std::istream &in)
+		{
+			buffer.assign(std::istreambuf_iterator<char>(in),
+			              std::istreambuf_iterator<char>());
+		}
+	};
+}
+
+#endif
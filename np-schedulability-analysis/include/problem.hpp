@@ -1,6 +1,8 @@
 #ifndef NP_PROBLEM_HPP
 #define NP_PROBLEM_HPP
 
+#include <iosfwd>
+
 #include "jobs.hpp"
 #include "precedence.hpp"
 #include "aborts.hpp"
@@ -78,13 +80,42 @@ namespace NP
 		// of the main workload index be?
 		std::size_t num_buckets;
 
+		// How many bytes may the states of the exploration front and of
+		// the next depth occupy? Exceeding it aborts the analysis.
+		// Zero means unlimited.
+		std::size_t memory_budget;
+
 		// Should we use state-merging techniques or naively explore the
 		// whole state space in a brute-force manner (only useful as a
 		// baseline).
 		bool be_naive;
 
+		// Should interchangeable jobs (e.g., identical sibling nodes of a
+		// DAG) be dispatched in only one canonical order? Only supported
+		// by the global analysis.
+		bool symmetry_reduction;
+
+		// Is only the yes/no answer needed? Finish times are then kept
+		// only for jobs with successors (their successors' ready times
+		// depend on them), and the analysis stops at the first deadline
+		// miss. Only supported by the global analysis.
+		bool schedulability_only;
+
+		// How many exploration fronts should be kept, so that the analysis
+		// of a slightly changed workload can resume from one of them
+		// instead of exploring from scratch? Zero means none. Only
+		// supported by the global analysis (see
+		// Global::Exploration_checkpoints).
+		unsigned int checkpoints;
+
+		// Where should the schedule graph be streamed to, one depth at a
+		// time, as the exploration goes on (see trace.hpp)? Null means
+		// nowhere. The uniprocessor analysis supports it only with
+		// CONFIG_PARALLEL.
+		std::ostream *graph_trace;
+
 		Analysis_options()
-			: timeout(0), max_depth(0), early_exit(true), num_buckets(1000), be_naive(false)
+			: timeout(0), max_depth(0), early_exit(true), num_buckets(1000), memory_budget(0), be_naive(false), symmetry_reduction(false), schedulability_only(false), checkpoints(0), graph_trace(nullptr)
 		{
 		}
 	};
@@ -0,0 +1,473 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+#include <vector>
+
+#include "interval.hpp"
+#include "time.hpp"
+#include "jobs.hpp"
+#include "io.hpp"
+
+namespace NP {
+
+	// Schedule-graph traces
+	//
+	// A trace streams the schedule graph out of an analysis one depth at a
+	// time while the exploration goes on (see
+	// Analysis_options::graph_trace), instead of keeping the whole graph in
+	// memory until the end, as CONFIG_COLLECT_SCHEDULE_GRAPH does. It does
+	// not need a serial build either.
+	//
+	// Layout (all values in the byte order of the host):
+	//  - a header: the magic number, the kind of states, and the number
+	//    of processors;
+	//  - the jobs, as a binary job set without precedence constraints
+	//    (see write_binary_job_set());
+	//  - one block per depth: its depth, number of states, and number of
+	//    edges (64 bits each), the states of that depth, and the edges into
+	//    them from the previous depth. The first block holds the states
+	//    the exploration started from (the initial state, or the front of
+	//    a checkpoint) and no edges.
+	// States are numbered in the order in which they appear in the trace.
+	// A state of the uniprocessor analysis is its finish range and the
+	// earliest release of a pending job. A state of the global analysis is
+	// the availability intervals of the cores, the number of its certainly
+	// running jobs (32 bits), and for each the job index (32 bits) and
+	// finish range. An edge is its source and target states (64 bits
+	// each), the index of the dispatched job (32 bits), and its finish
+	// range.
+
+	inline const char *graph_trace_magic()
+	{
+		// not text, just as binary_job_set_magic()
+		return "\x89NPGRAPH";
+	}
+
+	const std::size_t GRAPH_TRACE_HEADER = 16;
+
+	// what the states of a trace describe
+	enum class Trace_states : char {
+		uniproc = 'U',
+		global = 'G'
+	};
+
+	inline bool is_graph_trace(const char *begin, const char *end)
+	{
+		return end - begin >= (std::ptrdiff_t) GRAPH_TRACE_HEADER
+		       && !std::memcmp(begin, graph_trace_magic(), 8);
+	}
+
+	// whether the trace was written with an integral Time
+	inline bool is_discrete_graph_trace(const char *begin, const char *end)
+	{
+		return end - begin
+		       >= (std::ptrdiff_t) (GRAPH_TRACE_HEADER
+		                            + BINARY_JOB_SET_HEADER)
+		       && begin[GRAPH_TRACE_HEADER + 9];
+	}
+
+	template<class Time>
+	class Graph_trace_writer
+	{
+		public:
+
+		Graph_trace_writer(std::ostream &out,
+		                   const typename Job<Time>::Job_set &jobs,
+		                   Trace_states kind,
+		                   unsigned int num_processors)
+		: out(out), num_states(0), pending_states(0), pending_edges(0)
+		{
+			char header[GRAPH_TRACE_HEADER] = {};
+			std::memcpy(header, graph_trace_magic(), 8);
+			header[8] = (char) kind;
+			std::uint32_t m = num_processors;
+			std::memcpy(header + 12, &m, sizeof(m));
+			out.write(header, sizeof(header));
+			write_binary_job_set<Time>(out, jobs, Precedence_constraints());
+		}
+
+		// the number of the next state to be written
+		std::uint64_t number_of_states() const
+		{
+			return num_states;
+		}
+
+		// starts the block of the given depth, with exactly num_states
+		// calls of uniproc_state() or global_state() and then exactly
+		// num_edges calls of edge() to follow
+		void begin_depth(std::uint64_t depth, std::uint64_t num_states,
+		                 std::uint64_t num_edges)
+		{
+			assert(!pending_states && !pending_edges);
+			std::uint64_t counts[3] = {depth, num_states, num_edges};
+			write(counts);
+			pending_states = num_states;
+			pending_edges = num_edges;
+		}
+
+		void uniproc_state(const Interval<Time> &finish_range,
+		                   Time earliest_release)
+		{
+			assert(pending_states);
+			Time times[3] = {finish_range.from(), finish_range.until(),
+			                 earliest_release};
+			write(times);
+			pending_states--;
+			num_states++;
+		}
+
+		// the cores are Interval<Time>, the running jobs pairs of a job
+		// index and an Interval<Time>
+		template<class Cores, class Running_jobs>
+		void global_state(const Cores &core_avail,
+		                  const Running_jobs &certain_jobs)
+		{
+			assert(pending_states);
+			for (const Interval<Time> &a : core_avail) {
+				Time times[2] = {a.from(), a.until()};
+				write(times);
+			}
+			std::uint32_t n = certain_jobs.size();
+			write(n);
+			for (const auto &rj : certain_jobs) {
+				std::uint32_t j = rj.first;
+				Time times[2] = {rj.second.from(), rj.second.until()};
+				write(j);
+				write(times);
+			}
+			pending_states--;
+			num_states++;
+		}
+
+		void edge(std::uint64_t source, std::uint64_t target,
+		          std::size_t job, const Interval<Time> &finish_range)
+		{
+			assert(!pending_states && pending_edges);
+			std::uint64_t ends[2] = {source, target};
+			std::uint32_t j = job;
+			Time times[2] = {finish_range.from(), finish_range.until()};
+			write(ends);
+			write(j);
+			write(times);
+			pending_edges--;
+		}
+
+		// hands the finished block over to the file
+		void end_depth()
+		{
+			assert(!pending_states && !pending_edges);
+			out.flush();
+		}
+
+		private:
+
+		std::ostream &out;
+		std::uint64_t num_states, pending_states, pending_edges;
+
+		template<typename T>
+		void write(const T &value)
+		{
+			out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+		}
+	};
+
+	// A trace written by Graph_trace_writer, read in place (e.g., from a
+	// Mapped_file, which must outlive it). Only the edges are decoded up
+	// front; the states are decoded when printed.
+	template<class Time>
+	class Graph_trace
+	{
+		public:
+
+		typedef typename Job<Time>::Job_set Workload;
+
+		struct Edge
+		{
+			std::uint64_t source, target;
+			std::size_t job;
+			Interval<Time> finish_range;
+		};
+
+		struct Depth
+		{
+			std::uint64_t depth;
+			std::uint64_t first_state, num_states;
+			std::uint64_t first_edge, num_edges;
+		};
+
+		// throws std::ios_base::failure if [begin, end) is not a trace
+		// written with the same Time; a block cut short (e.g., by a crash
+		// of the analysis) ends the trace (see is_complete())
+		Graph_trace(const char *begin, const char *end)
+		: complete(true)
+		{
+			if (!is_graph_trace(begin, end))
+				throw std::ios_base::failure("not a schedule-graph trace");
+			states_of = (Trace_states) begin[8];
+			if (states_of != Trace_states::uniproc
+			    && states_of != Trace_states::global)
+				throw std::ios_base::failure("unknown kind of states");
+			std::uint32_t m;
+			std::memcpy(&m, begin + 12, sizeof(m));
+			num_cpus = m;
+
+			const char *pos = begin + GRAPH_TRACE_HEADER;
+			auto num_jobs = binary_job_set_size(pos, end);
+			const std::size_t job_size = 2 * sizeof(std::uint64_t)
+			                             + 6 * sizeof(Time);
+			if (num_jobs > (std::uint64_t) (end - pos) / job_size
+			    || (std::uint64_t) (end - pos)
+			       < BINARY_JOB_SET_HEADER + num_jobs * job_size)
+				throw std::ios_base::failure("truncated schedule-graph trace");
+			const char *jobs_end = pos + BINARY_JOB_SET_HEADER
+			                       + num_jobs * job_size;
+			Precedence_constraints no_dag;
+			parse_binary_job_set<Time>(pos, jobs_end, jobs, no_dag);
+			pos = jobs_end;
+
+			while (pos != end && read_depth(pos, end))
+				/* next block */;
+		}
+
+		const Workload &get_jobs() const
+		{
+			return jobs;
+		}
+
+		Trace_states kind() const
+		{
+			return states_of;
+		}
+
+		unsigned int number_of_processors() const
+		{
+			return num_cpus;
+		}
+
+		// false if the trace ends with a truncated block, which is ignored
+		bool is_complete() const
+		{
+			return complete;
+		}
+
+		std::uint64_t number_of_states() const
+		{
+			return state_records.size();
+		}
+
+		// in the order of the trace, i.e., by the depth of their targets
+		const std::vector<Edge> &get_edges() const
+		{
+			return edges;
+		}
+
+		// in the order of the trace
+		const std::vector<Depth> &get_depths() const
+		{
+			return depths;
+		}
+
+		std::uint64_t depth_of(std::uint64_t state) const
+		{
+			auto d = std::upper_bound(
+				depths.begin(), depths.end(), state,
+				[](std::uint64_t s, const Depth &d) {
+					return s < d.first_state;
+				});
+			return (d - 1)->depth;
+		}
+
+		bool deadline_miss_possible(const Edge &e) const
+		{
+			return jobs[e.job].exceeds_deadline(e.finish_range.upto());
+		}
+
+		// as with CONFIG_COLLECT_SCHEDULE_GRAPH
+		void print_state_label(std::ostream &out, std::uint64_t state) const
+		{
+			const char *pos = state_records[state];
+			if (states_of == Trace_states::uniproc) {
+				Time times[3];
+				std::memcpy(times, pos, sizeof(times));
+				out << "[" << times[0] << ", " << times[1] << "]\\nER=";
+				if (times[2] == Time_model::constants<Time>::infinity())
+					out << "N/A";
+				else
+					out << times[2];
+				return;
+			}
+			for (unsigned int c = 0; c < num_cpus; c++) {
+				Time times[2];
+				std::memcpy(times, pos, sizeof(times));
+				pos += sizeof(times);
+				out << "[" << times[0] << ", " << times[1] << "] ";
+			}
+			std::uint32_t n;
+			std::memcpy(&n, pos, sizeof(n));
+			pos += sizeof(n);
+			out << "\\n{";
+			for (std::uint32_t i = 0; i < n; i++) {
+				std::uint32_t j;
+				Time times[2];
+				std::memcpy(&j, pos, sizeof(j));
+				std::memcpy(times, pos + sizeof(j), sizeof(times));
+				pos += sizeof(j) + sizeof(times);
+				if (i)
+					out << ", ";
+				out << "T" << jobs[j].get_task_id()
+				    << "J" << jobs[j].get_job_id() << ":"
+				    << times[0] << "-" << times[1];
+			}
+			out << "}";
+		}
+
+		private:
+
+		Workload jobs;
+		Trace_states states_of;
+		unsigned int num_cpus;
+		bool complete;
+		std::vector<const char *> state_records;
+		std::vector<Edge> edges;
+		std::vector<Depth> depths;
+
+		std::size_t state_size(const char *pos, const char *end) const
+		{
+			if (states_of == Trace_states::uniproc)
+				return 3 * sizeof(Time);
+			std::size_t fixed = num_cpus * 2 * sizeof(Time);
+			std::uint32_t n;
+			if ((std::size_t) (end - pos) < fixed + sizeof(n))
+				return end - pos + 1;
+			std::memcpy(&n, pos + fixed, sizeof(n));
+			return fixed + sizeof(n)
+			       + n * (sizeof(std::uint32_t) + 2 * sizeof(Time));
+		}
+
+		// reads the block at pos, or returns false if it is truncated
+		bool read_depth(const char *&pos, const char *end)
+		{
+			const std::size_t edge_size = 2 * sizeof(std::uint64_t)
+			                              + sizeof(std::uint32_t)
+			                              + 2 * sizeof(Time);
+			std::uint64_t counts[3];
+			const char *p = pos;
+			if ((std::size_t) (end - p) < sizeof(counts))
+				return complete = false;
+			std::memcpy(counts, p, sizeof(counts));
+			p += sizeof(counts);
+
+			auto first_state = state_records.size();
+			for (std::uint64_t i = 0; i < counts[1]; i++) {
+				auto size = state_size(p, end);
+				if ((std::size_t) (end - p) < size) {
+					state_records.resize(first_state);
+					return complete = false;
+				}
+				state_records.push_back(p);
+				p += size;
+			}
+			if (counts[2] > (std::size_t) (end - p) / edge_size) {
+				state_records.resize(first_state);
+				return complete = false;
+			}
+
+			auto first_edge = edges.size();
+			for (std::uint64_t i = 0; i < counts[2]; i++, p += edge_size) {
+				std::uint64_t ends[2];
+				std::uint32_t j;
+				Time times[2];
+				std::memcpy(ends, p, sizeof(ends));
+				std::memcpy(&j, p + sizeof(ends), sizeof(j));
+				std::memcpy(times, p + sizeof(ends) + sizeof(j),
+				            sizeof(times));
+				if (ends[0] >= first_state || ends[1] < first_state
+				    || ends[1] >= state_records.size() || j >= jobs.size())
+					throw std::ios_base::failure(
+						"malformed schedule-graph trace");
+				edges.push_back(Edge{ends[0], ends[1], j,
+				                     Interval<Time>{times[0], times[1]}});
+			}
+
+			depths.push_back(Depth{counts[0], first_state, counts[1],
+			                       first_edge, counts[2]});
+			pos = p;
+			return true;
+		}
+	};
+
+	// the edges from which a possible deadline miss can be reached,
+	// including the edges that may miss a deadline themselves
+	template<class Time>
+	std::vector<bool> edges_to_deadline_misses(const Graph_trace<Time> &trace)
+	{
+		const auto &edges = trace.get_edges();
+		std::vector<bool> to_miss(edges.size(), false);
+		std::vector<bool> reaches_miss(trace.number_of_states(), false);
+		// the edges out of a depth follow the edges into it
+		for (std::size_t i = edges.size(); i-- > 0; ) {
+			const auto &e = edges[i];
+			if (trace.deadline_miss_possible(e) || reaches_miss[e.target]) {
+				to_miss[i] = true;
+				reaches_miss[e.source] = true;
+			}
+		}
+		return to_miss;
+	}
+
+	// the given states and edges of the trace in Graphviz dot format, as
+	// with CONFIG_COLLECT_SCHEDULE_GRAPH
+	template<class Time>
+	void write_dot(std::ostream &out, const Graph_trace<Time> &trace,
+	               const std::vector<bool> &with_state,
+	               const std::vector<bool> &with_edge)
+	{
+		out << "digraph {" << std::endl;
+		for (std::uint64_t s = 0; s < trace.number_of_states(); s++) {
+			if (!with_state[s])
+				continue;
+			out << "\tS" << s << "[label=\"S" << s << ": ";
+			trace.print_state_label(out, s);
+			out << "\"];" << std::endl;
+		}
+		const auto &edges = trace.get_edges();
+		for (std::size_t i = 0; i < edges.size(); i++) {
+			if (!with_edge[i])
+				continue;
+			const auto &e = edges[i];
+			const Job<Time> &j = trace.get_jobs()[e.job];
+			bool miss = trace.deadline_miss_possible(e);
+			out << "\tS" << e.source
+			    << " -> "
+			    << "S" << e.target
+			    << "[label=\""
+			    << "T" << j.get_task_id()
+			    << " J" << j.get_job_id()
+			    << "\\nDL=" << j.get_deadline()
+			    << "\\nES=" << e.finish_range.from() - j.least_cost()
+			    << "\\nLS=" << e.finish_range.upto() - j.maximal_cost()
+			    << "\\nEF=" << e.finish_range.from()
+			    << "\\nLF=" << e.finish_range.upto()
+			    << "\"";
+			if (miss)
+				out << ",color=Red,fontcolor=Red";
+			out << ",fontsize=8"
+			    << "]"
+			    << ";"
+			    << std::endl;
+			if (miss)
+				out << "S" << e.target
+				    << "[color=Red];"
+				    << std::endl;
+		}
+		out << "}" << std::endl;
+	}
+}
+
+#endif
@@ -8,16 +8,26 @@
 #include <deque>
 #include <list>
 #include <algorithm>
+#include <memory>
 
 #include <iostream>
 #include <ostream>
 #include <cassert>
 
 #include "config.h"
+
+#ifdef CONFIG_PARALLEL
+#include <atomic>
+
+#include "tbb/enumerable_thread_specific.h"
+#include "tbb/parallel_for.h"
+#endif
+
 #include "problem.hpp"
 #include "jobs.hpp"
 #include "precedence.hpp"
 #include "clock.hpp"
+#include "trace.hpp"
 
 #include "uni/state.hpp"
 
@@ -43,6 +53,38 @@ namespace NP {
 				// this is a uniprocessor analysis
 				assert(prob.num_processors == 1);
 
+#ifdef CONFIG_PARALLEL
+				auto s = State_space(prob.jobs, prob.dag, prob.aborts,
+				                     opts.timeout, opts.max_depth,
+				                     opts.num_buckets, opts.early_exit);
+				s.cpu_time.start();
+				std::unique_ptr<Graph_trace_writer<Time>> trace;
+				if (opts.graph_trace) {
+					trace.reset(new Graph_trace_writer<Time>(
+						*opts.graph_trace, prob.jobs, Trace_states::uniproc,
+						1));
+					s.trace = trace.get();
+				}
+				s.explore_by_depth(!opts.be_naive);
+				s.trace = nullptr;
+				s.cpu_time.stop();
+				return s;
+#else
+				return explore_serially(prob, opts);
+#endif
+			}
+
+			// the exploration of a single-threaded build, one state at a
+			// time; parallel builds explore depth by depth instead, and
+			// find the same states, edges and finish times
+			static State_space explore_serially(
+					const Problem& prob,
+					const Analysis_options& opts)
+			{
+				assert(prob.num_processors == 1);
+				// traces are written by the exploration by depth
+				assert(!opts.graph_trace);
+
 				auto s = State_space(prob.jobs, prob.dag, prob.aborts,
 				                     opts.timeout, opts.max_depth,
 				                     opts.num_buckets, opts.early_exit);
@@ -224,6 +266,9 @@ namespace NP {
 			bool early_exit;
 			bool observed_deadline_miss;
 
+			// the schedule graph is streamed to it, if given
+			Graph_trace_writer<Time>* trace;
+
 			State_space(const Workload& jobs,
 			            const Precedence_constraints &dag_edges,
 			            const Abort_actions& aborts,
@@ -246,6 +291,7 @@ namespace NP {
 			, early_exit(early_exit)
 			, observed_deadline_miss(false)
 			, abort_actions(jobs.size(), NULL)
+			, trace(nullptr)
 			{
 				for (const Job<Time>& j : jobs) {
 					jobs_by_latest_arrival.insert({j.latest_arrival(), &j});
@@ -940,6 +986,250 @@ namespace NP {
 				}
 			}
 
+#ifdef CONFIG_PARALLEL
+
+			// Parallel exploration, one depth at a time. First, the states of
+			// the front are expanded concurrently. Then the new states are
+			// merged concurrently, by shards of their keys, each shard by a
+			// single worker. Each shard considers its transitions in the
+			// order in which explore() would, and the new states are
+			// created in that order, too. Hence, the states, the edges, and
+			// the response times are the same as explore()'s (and
+			// explore_naively()'s), regardless of the number of workers.
+			// Only an early exit differs: it still completes the depth of
+			// the deadline miss.
+
+			// a transition found while expanding a state of the front
+			struct Successor
+			{
+				std::size_t parent;
+				const Job<Time>* job;
+				Interval<Time> finish_range;
+				// of the state it leads to, widened by the merged ones
+				Interval<Time> state_finish_range;
+				Time earliest_release;
+				hash_value_t key;
+				// the transition whose new state it merges into, or null
+				// if it leads to a new state
+				Successor* merged_into;
+				// the position of its new state in the next depth
+				std::size_t target;
+			};
+
+			typedef std::vector<std::vector<Successor>> Successors;
+
+			// by job index
+			typedef std::unordered_map<std::size_t, Interval<Time>>
+				Finish_times;
+
+			typedef std::unordered_multimap<hash_value_t, Successor*>
+				Merge_table;
+
+			static const std::size_t MERGE_SHARD_BITS = 6;
+			static const std::size_t NUM_MERGE_SHARDS = 1 << MERGE_SHARD_BITS;
+
+			// below this many transitions, a depth is merged by one worker
+			static const std::size_t MIN_PARALLEL_MERGE = 256;
+
+			// appends the transitions out of state s, the parent-th state of
+			// the front, and notes their finish times; returns false on a
+			// dead end
+			bool expand(const State &s, std::size_t parent,
+			            std::vector<Successor> &found,
+			            Finish_times &finish_times)
+			{
+				// Identify relevant interval for next job
+				auto ts_min = s.earliest_finish_time();
+				auto rel_min = s.earliest_job_release();
+				auto t_l = std::max(next_eligible_job_ready(s), s.latest_finish_time());
+
+				Interval<Time> next_range{std::min(ts_min, rel_min), t_l};
+
+				const Job<Time>* jp;
+				foreach_possbly_pending_job_until(s, jp, next_range.upto()) {
+					const Job<Time>& j = *jp;
+					if (!is_eligible_successor(s, j))
+						continue;
+					Interval<Time> finish_range = next_finish_times(s, j);
+					found.push_back(Successor{
+						parent, &j, finish_range, finish_range,
+						earliest_possible_job_release(s, j), s.next_key(j),
+						nullptr, 0});
+					auto f = finish_times.emplace(index_of(j), finish_range);
+					if (!f.second)
+						f.first->second.widen(finish_range);
+				}
+
+				return !found.empty()
+				       || s.get_scheduled_jobs().size() == jobs.size();
+			}
+
+			// merges each transition of the shard into the first earlier
+			// one that leads to the same job set with an overlapping finish
+			// range, as schedule() does
+			void merge_shard(const std::deque<State> &front,
+			                 const std::vector<Successor*> &shard,
+			                 Merge_table &table)
+			{
+				table.clear();
+				for (Successor *c : shard) {
+					const Job_set &scheduled =
+						front[c->parent].get_scheduled_jobs();
+					auto r = table.equal_range(c->key);
+					for (auto it = r.first; it != r.second; it++) {
+						Successor &found = *it->second;
+						if (!front[found.parent].get_scheduled_jobs()
+						         .equals_with(index_of(*found.job), scheduled,
+						                      index_of(*c->job)))
+							continue;
+						if (!c->finish_range.intersects(found.state_finish_range))
+							continue;
+						found.state_finish_range.widen(c->finish_range);
+						c->merged_into = &found;
+						break;
+					}
+					if (!c->merged_into)
+						table.emplace(c->key, c);
+				}
+			}
+
+			// streams the new states, and the transitions into them, to the
+			// trace; the states of the front were the last ones written
+			void trace_depth(const std::deque<State> &front,
+			                 const Successors &successors,
+			                 const std::deque<State> &next,
+			                 std::size_t num_transitions)
+			{
+				auto first_source = trace->number_of_states() - front.size();
+				auto first_target = trace->number_of_states();
+				trace->begin_depth(current_job_count + 1, next.size(),
+				                   num_transitions);
+				for (const State &s : next)
+					trace->uniproc_state(s.finish_range(),
+					                     s.earliest_job_release());
+				for (std::size_t i = 0; i < front.size(); i++)
+					for (const Successor &c : successors[i]) {
+						const Successor &to =
+							c.merged_into ? *c.merged_into : c;
+						trace->edge(first_source + i, first_target + to.target,
+						            index_of(*c.job), c.finish_range);
+					}
+				trace->end_depth();
+			}
+
+			void explore_by_depth(bool merge)
+			{
+				std::deque<State> front, next;
+				Successors successors;
+				tbb::enumerable_thread_specific<Finish_times> finish_times;
+				std::vector<std::vector<Successor*>> shards(NUM_MERGE_SHARDS);
+				std::vector<Merge_table> tables(NUM_MERGE_SHARDS);
+
+				front.emplace_back();
+				num_states = 1;
+				if (trace) {
+					trace->begin_depth(0, 1, 0);
+					trace->uniproc_state(front[0].finish_range(),
+					                     front[0].earliest_job_release());
+					trace->end_depth();
+				}
+
+				while (!front.empty() && !aborted) {
+					std::size_t n = front.size();
+					if (successors.size() < n)
+						successors.resize(n);
+					std::atomic<bool> dead_end(false), out_of_time(false);
+
+					tbb::parallel_for(tbb::blocked_range<std::size_t>(0, n),
+						[&](const tbb::blocked_range<std::size_t> &r) {
+							if (timeout && get_cpu_time() > timeout) {
+								out_of_time = true;
+								return;
+							}
+							Finish_times &local = finish_times.local();
+							for (std::size_t i = r.begin(); i != r.end(); i++) {
+								successors[i].clear();
+								if (!expand(front[i], i, successors[i], local))
+									dead_end = true;
+							}
+						});
+
+					if (out_of_time) {
+						aborted = true;
+						timed_out = true;
+						break;
+					}
+
+					std::size_t total = 0;
+					for (std::size_t i = 0; i < n; i++)
+						total += successors[i].size();
+					num_edges += total;
+
+					if (merge && total < MIN_PARALLEL_MERGE) {
+						shards[0].clear();
+						for (std::size_t i = 0; i < n; i++)
+							for (Successor &c : successors[i])
+								shards[0].push_back(&c);
+						merge_shard(front, shards[0], tables[0]);
+					} else if (merge) {
+						for (auto &shard : shards)
+							shard.clear();
+						for (std::size_t i = 0; i < n; i++)
+							for (Successor &c : successors[i])
+								shards[c.key >> (64 - MERGE_SHARD_BITS)]
+									.push_back(&c);
+						tbb::parallel_for(
+							tbb::blocked_range<std::size_t>(
+								0, NUM_MERGE_SHARDS, 1),
+							[&](const tbb::blocked_range<std::size_t> &r) {
+								for (std::size_t k = r.begin(); k != r.end(); k++)
+									merge_shard(front, shards[k], tables[k]);
+							});
+					}
+
+					// create the new states in the order of explore()
+					for (std::size_t i = 0; i < n; i++)
+						for (Successor &c : successors[i])
+							if (!c.merged_into) {
+								c.target = next.size();
+								next.emplace_back(front[i], *c.job,
+								                  index_of(*c.job),
+								                  c.state_finish_range,
+								                  c.earliest_release);
+							}
+					num_states += next.size();
+					if (trace)
+						trace_depth(front, successors, next, total);
+					if (!next.empty())
+						width = std::max(width,
+						                 (unsigned long) next.size() - 1);
+
+					// propagate the new finish times, in any order
+					for (Finish_times &local : finish_times) {
+						for (const auto &f : local)
+							update_finish_times(jobs[f.first], f.second);
+						local.clear();
+					}
+
+					if (dead_end) {
+						// out of options and we didn't schedule all jobs
+						observed_deadline_miss = true;
+						if (early_exit)
+							aborted = true;
+					}
+
+					if (max_depth && current_job_count == max_depth)
+						aborted = true;
+					current_job_count++;
+
+					front.swap(next);
+					next.clear();
+					check_cpu_timeout();
+				}
+			}
+
+#endif
+
 #ifdef CONFIG_COLLECT_SCHEDULE_GRAPH
 			friend std::ostream& operator<< (std::ostream& out,
 			                                 const State_space<Time, IIP>& space)
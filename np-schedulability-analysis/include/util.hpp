@@ -4,6 +4,15 @@
 #include <iostream>
 #include <fstream>
 #include <algorithm>
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+#include "config.h"
+
+#ifdef CONFIG_PARALLEL
+#include "tbb/parallel_sort.h"
+#endif
 
 namespace NP {
 
@@ -26,6 +35,94 @@ namespace NP {
 		f << obj;
 		f.close();
 	}
+
+	// A read-only std::multimap: the entries sorted by key in one array,
+	// equal keys in the order given, searched with a branch-free binary
+	// search. The usual pattern of a search followed by an in-order scan
+	// benefits from the array order, so it is kept as is.
+	template<class Key, class Value>
+	class Sorted_multimap
+	{
+		public:
+
+		typedef std::pair<Key, Value> value_type;
+		typedef const value_type *const_iterator;
+
+		Sorted_multimap()
+		{
+		}
+
+		explicit Sorted_multimap(const std::vector<value_type> &unsorted)
+		{
+			// sort the keys with their positions, which makes the order
+			// of equal keys deterministic also for a parallel sort
+			std::vector<std::pair<Key, std::size_t>> order;
+			order.reserve(unsorted.size());
+			for (std::size_t i = 0; i < unsorted.size(); i++)
+				order.emplace_back(unsorted[i].first, i);
+#ifdef CONFIG_PARALLEL
+			tbb::parallel_sort(order.begin(), order.end());
+#else
+			std::sort(order.begin(), order.end());
+#endif
+			entries.reserve(unsorted.size());
+			for (const auto &o : order)
+				entries.push_back(unsorted[o.second]);
+		}
+
+		const_iterator begin() const
+		{
+			return entries.data();
+		}
+
+		const_iterator end() const
+		{
+			return entries.data() + entries.size();
+		}
+
+		std::size_t size() const
+		{
+			return entries.size();
+		}
+
+		// first entry with a key not less than the given one
+		const_iterator lower_bound(const Key &key) const
+		{
+			return search(key, [](const Key &k, const Key &key) {
+				return k < key;
+			});
+		}
+
+		// first entry with a key greater than the given one
+		const_iterator upper_bound(const Key &key) const
+		{
+			return search(key, [](const Key &k, const Key &key) {
+				return !(key < k);
+			});
+		}
+
+		private:
+
+		std::vector<value_type> entries;
+
+		// first entry whose key is not before the given one
+		template<class Before>
+		const_iterator search(const Key &key, Before before) const
+		{
+			std::size_t n = entries.size();
+			if (n == 0)
+				return end();
+			const value_type *base = entries.data();
+			// halve the range without branching on the comparison,
+			// which the compiler turns into a conditional move
+			while (n > 1) {
+				std::size_t half = n / 2;
+				base = before(base[half].first, key) ? base + half : base;
+				n -= half;
+			}
+			return base + before(base->first, key);
+		}
+	};
 }
 
 #endif
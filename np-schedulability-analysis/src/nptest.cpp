@@ -2,6 +2,11 @@
 #include <sstream>
 #include <fstream>
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #ifndef _WIN32
 #include <sys/resource.h>
@@ -13,6 +18,7 @@
 
 #ifdef CONFIG_PARALLEL
 
+#include "tbb/task_arena.h"
 #include "tbb/task_scheduler_init.h"
 
 #endif
@@ -21,6 +27,7 @@
 #include "uni/space.hpp"
 #include "global/space.hpp"
 #include "io.hpp"
+#include "mapped_file.hpp"
 #include "clock.hpp"
 
 
@@ -46,9 +53,19 @@ static bool want_dot_graph;
 #endif
 static double timeout;
 static unsigned int max_depth = 0;
+static std::size_t memory_budget = 0;
+// of each analysis; a share of memory_budget when analyzing side by side
+static std::size_t analysis_memory_budget = 0;
+static std::size_t batch_max_jobs = 0;
+static bool want_symmetry_reduction = false;
+static bool want_hash_statistics = false;
 
 static bool want_rta_file;
 
+static bool want_binary_file;
+
+static bool want_trace_file;
+
 static bool continue_after_dl_miss = false;
 
 #ifdef CONFIG_PARALLEL
@@ -62,26 +79,87 @@ struct Analysis_result {
 	double cpu_time;
 	std::string graph;
 	std::string response_times_csv;
+	std::string binary_job_set;
+	bool out_of_memory;
+	std::size_t peak_frontier_memory;
+	unsigned long hash_lookups, hash_probes, hash_max_probe;
+	unsigned long merge_candidates, key_collisions;
 };
 
+// only the global analysis supports a memory budget
+template<class Space>
+static bool was_out_of_memory(const Space &space)
+{
+	return false;
+}
+
+template<class Time>
+static bool was_out_of_memory(const NP::Global::State_space<Time> &space)
+{
+	return space.was_out_of_memory();
+}
+
+template<class Space>
+static std::size_t peak_frontier_memory(const Space &space)
+{
+	return 0;
+}
+
+template<class Time>
+static std::size_t peak_frontier_memory(
+	const NP::Global::State_space<Time> &space)
+{
+	return space.peak_frontier_memory();
+}
+
+// only the global analysis reports the statistics of its state lookup keys
+template<class Space>
+static void add_hash_statistics(const Space &space, Analysis_result &result)
+{
+	result.hash_lookups = result.hash_probes = result.hash_max_probe = 0;
+	result.merge_candidates = result.key_collisions = 0;
+}
+
+template<class Time>
+static void add_hash_statistics(const NP::Global::State_space<Time> &space,
+                                Analysis_result &result)
+{
+	auto stats = space.hash_statistics();
+	result.hash_lookups = stats.lookups;
+	result.hash_probes = stats.probes;
+	result.hash_max_probe = stats.max_probe;
+	result.merge_candidates = stats.candidates;
+	result.key_collisions = stats.collisions;
+}
+
 template<class Time, class Space>
 static Analysis_result analyze(
-	std::istream &in,
-	std::istream &dag_in,
-	std::istream &aborts_in)
+	const NP::Mapped_file &in,
+	const NP::Mapped_file &dag_in,
+	std::istream &aborts_in,
+	std::ostream *trace)
 {
-#ifdef CONFIG_PARALLEL
-	tbb::task_scheduler_init init(
-		num_worker_threads ? num_worker_threads : tbb::task_scheduler_init::automatic);
-#endif
+	// Parse input files and create NP scheduling problem description; a
+	// binary job set may come with precedence constraints of its own
+	typename NP::Job<Time>::Job_set jobs;
+	NP::Precedence_constraints dag;
+	if (NP::is_binary_job_set(in.begin(), in.end()))
+		NP::parse_binary_job_set<Time>(in.begin(), in.end(), jobs, dag);
+	else
+		jobs = NP::parse_file<Time>(in.begin(), in.end());
+	auto extra_dag = NP::parse_dag_file(dag_in.begin(), dag_in.end());
+	dag.insert(dag.end(), extra_dag.begin(), extra_dag.end());
 
-	// Parse input files and create NP scheduling problem description
 	NP::Scheduling_problem<Time> problem{
-		NP::parse_file<Time>(in),
-		NP::parse_dag_file(dag_in),
+		std::move(jobs),
+		std::move(dag),
 		NP::parse_abort_file<Time>(aborts_in),
 		num_processors};
 
+	auto binary = std::ostringstream();
+	if (want_binary_file)
+		NP::write_binary_job_set<Time>(binary, problem.jobs, problem.dag);
+
 	// Set common analysis options
 	NP::Analysis_options opts;
 	opts.timeout = timeout;
@@ -89,6 +167,9 @@ static Analysis_result analyze(
 	opts.early_exit = !continue_after_dl_miss;
 	opts.num_buckets = problem.jobs.size();
 	opts.be_naive = want_naive;
+	opts.memory_budget = analysis_memory_budget;
+	opts.symmetry_reduction = want_symmetry_reduction;
+	opts.graph_trace = trace;
 
 	// Actually call the analysis engine
 	auto space = Space::explore(problem, opts);
@@ -118,7 +199,7 @@ static Analysis_result analyze(
 		}
 	}
 
-	return {
+	Analysis_result result{
 		space.is_schedulable(),
 		space.was_timed_out(),
 		space.number_of_states(),
@@ -127,66 +208,88 @@ static Analysis_result analyze(
 		problem.jobs.size(),
 		space.get_cpu_time(),
 		graph.str(),
-		rta.str()
+		rta.str(),
+		binary.str(),
+		was_out_of_memory(space),
+		peak_frontier_memory(space)
 	};
+	add_hash_statistics(space, result);
+	return result;
 }
 
 static Analysis_result process_stream(
-	std::istream &in,
-	std::istream &dag_in,
-	std::istream &aborts_in)
+	const NP::Mapped_file &in,
+	const NP::Mapped_file &dag_in,
+	std::istream &aborts_in,
+	std::ostream *trace)
 {
 	if (want_multiprocessor && want_dense)
-		return analyze<dense_t, NP::Global::State_space<dense_t>>(in, dag_in, aborts_in);
+		return analyze<dense_t, NP::Global::State_space<dense_t>>(in, dag_in, aborts_in, trace);
 	else if (want_multiprocessor && !want_dense)
-		return analyze<dtime_t, NP::Global::State_space<dtime_t>>(in, dag_in, aborts_in);
+		return analyze<dtime_t, NP::Global::State_space<dtime_t>>(in, dag_in, aborts_in, trace);
 	else if (want_dense && want_prm_iip)
-		return analyze<dense_t, NP::Uniproc::State_space<dense_t, NP::Uniproc::Precatious_RM_IIP<dense_t>>>(in, dag_in, aborts_in);
+		return analyze<dense_t, NP::Uniproc::State_space<dense_t, NP::Uniproc::Precatious_RM_IIP<dense_t>>>(in, dag_in, aborts_in, trace);
 	else if (want_dense && want_cw_iip)
-		return analyze<dense_t, NP::Uniproc::State_space<dense_t, NP::Uniproc::Critical_window_IIP<dense_t>>>(in, dag_in, aborts_in);
+		return analyze<dense_t, NP::Uniproc::State_space<dense_t, NP::Uniproc::Critical_window_IIP<dense_t>>>(in, dag_in, aborts_in, trace);
 	else if (want_dense && !want_prm_iip)
-		return analyze<dense_t, NP::Uniproc::State_space<dense_t>>(in, dag_in, aborts_in);
+		return analyze<dense_t, NP::Uniproc::State_space<dense_t>>(in, dag_in, aborts_in, trace);
 	else if (!want_dense && want_prm_iip)
-		return analyze<dtime_t, NP::Uniproc::State_space<dtime_t, NP::Uniproc::Precatious_RM_IIP<dtime_t>>>(in, dag_in, aborts_in);
+		return analyze<dtime_t, NP::Uniproc::State_space<dtime_t, NP::Uniproc::Precatious_RM_IIP<dtime_t>>>(in, dag_in, aborts_in, trace);
 	else if (!want_dense && want_cw_iip)
-		return analyze<dtime_t, NP::Uniproc::State_space<dtime_t, NP::Uniproc::Critical_window_IIP<dtime_t>>>(in, dag_in, aborts_in);
+		return analyze<dtime_t, NP::Uniproc::State_space<dtime_t, NP::Uniproc::Critical_window_IIP<dtime_t>>>(in, dag_in, aborts_in, trace);
 	else
-		return analyze<dtime_t, NP::Uniproc::State_space<dtime_t>>(in, dag_in, aborts_in);
+		return analyze<dtime_t, NP::Uniproc::State_space<dtime_t>>(in, dag_in, aborts_in, trace);
 }
 
-static void process_file(const std::string& fname)
+// writes the summary line of the job set in the given file, or an error
+// message; returns the exit status of nptest (zero on success)
+static int process_file(const std::string& fname,
+                        std::ostream &summary,
+                        std::ostream &errors)
 {
 	try {
 		Analysis_result result;
 
-		auto empty_dag_stream = std::istringstream("\n");
 		auto empty_aborts_stream = std::istringstream("\n");
-		auto dag_stream = std::ifstream();
 		auto aborts_stream = std::ifstream();
 
+		NP::Mapped_file dag_in;
 		if (want_precedence)
-			dag_stream.open(precedence_file);
+			dag_in = NP::Mapped_file(precedence_file);
 
 		if (want_aborts)
 			aborts_stream.open(aborts_file);
 
-		std::istream &dag_in = want_precedence ?
-			static_cast<std::istream&>(dag_stream) :
-			static_cast<std::istream&>(empty_dag_stream);
-
 		std::istream &aborts_in = want_aborts ?
 			static_cast<std::istream&>(aborts_stream) :
 			static_cast<std::istream&>(empty_aborts_stream);
 
+		// the schedule graph is streamed to it during the analysis
+		auto trace = std::ofstream();
+		if (want_trace_file && fname != "-") {
+			std::string trace_name = fname;
+			auto p = trace_name.find(".csv");
+			if (p == std::string::npos)
+				p = trace_name.find(".bin");
+			if (p != std::string::npos) {
+				trace_name.replace(p, std::string::npos, ".trace");
+				trace.open(trace_name, std::ios::out | std::ios::binary);
+			}
+		}
+		std::ostream *trace_out = trace.is_open() ? &trace : nullptr;
+
 		if (fname == "-")
-			result = process_stream(std::cin, dag_in, aborts_in);
+			result = process_stream(NP::Mapped_file(std::cin), dag_in,
+			                        aborts_in, trace_out);
 		else {
-			auto in = std::ifstream(fname, std::ios::in);
-			result = process_stream(in, dag_in, aborts_in);
+			result = process_stream(NP::Mapped_file(fname), dag_in,
+			                        aborts_in, trace_out);
 #ifdef CONFIG_COLLECT_SCHEDULE_GRAPH
 			if (want_dot_graph) {
 				std::string dot_name = fname;
 				auto p = dot_name.find(".csv");
+				if (p == std::string::npos)
+					p = dot_name.find(".bin");
 				if (p != std::string::npos) {
 					dot_name.replace(p, std::string::npos, ".dot");
 					auto out  = std::ofstream(dot_name,  std::ios::out);
@@ -198,6 +301,8 @@ static void process_file(const std::string& fname)
 			if (want_rta_file) {
 				std::string rta_name = fname;
 				auto p = rta_name.find(".csv");
+				if (p == std::string::npos)
+					p = rta_name.find(".bin");
 				if (p != std::string::npos) {
 					rta_name.replace(p, std::string::npos, ".rta.csv");
 					auto out  = std::ofstream(rta_name,  std::ios::out);
@@ -205,6 +310,17 @@ static void process_file(const std::string& fname)
 					out.close();
 				}
 			}
+			if (want_binary_file) {
+				std::string bin_name = fname;
+				auto p = bin_name.find(".csv");
+				if (p != std::string::npos) {
+					bin_name.replace(p, std::string::npos, ".bin");
+					auto out  = std::ofstream(bin_name,
+					                          std::ios::out | std::ios::binary);
+					out << result.binary_job_set;
+					out.close();
+				}
+			}
 		}
 
 #ifdef _WIN32 // rusage does not work under Windows
@@ -216,48 +332,153 @@ static void process_file(const std::string& fname)
 			mem_used = u.ru_maxrss;
 #endif
 
-		std::cout << fname;
+		summary << fname;
 
 		if (max_depth && max_depth < result.number_of_jobs)
 			// mark result as invalid due to debug abort
-			std::cout << ",  X";
+			summary << ",  X";
 		else
-			std::cout << ",  " << (int) result.schedulable;
+			summary << ",  " << (int) result.schedulable;
 
-		std::cout << ",  " << result.number_of_jobs
+		summary << ",  " << result.number_of_jobs
 		          << ",  " << result.number_of_states
 		          << ",  " << result.number_of_edges
 		          << ",  " << result.max_width
 		          << ",  " << std::fixed << result.cpu_time
 		          << ",  " << ((double) mem_used) / (1024.0)
 		          << ",  " << (int) result.timeout
-		          << ",  " << num_processors
-		          << std::endl;
+		          << ",  " << num_processors;
+		if (memory_budget)
+			summary << ",  " << (int) result.out_of_memory
+			          << ",  " << result.peak_frontier_memory / 1024.0;
+		if (want_hash_statistics)
+			summary << ",  " << result.hash_lookups
+			          << ",  " << (result.hash_lookups ?
+			                       (double) result.hash_probes
+			                       / result.hash_lookups : 0.0)
+			          << ",  " << result.hash_max_probe
+			          << ",  " << result.merge_candidates
+			          << ",  " << result.key_collisions;
+		summary << std::endl;
+		return 0;
 	} catch (std::ios_base::failure& ex) {
-		std::cerr << fname;
+		errors << fname;
 		if (want_precedence)
-			std::cerr << " + " << precedence_file;
-		std::cerr <<  ": parse error" << std::endl;
-		exit(1);
+			errors << " + " << precedence_file;
+		errors <<  ": parse error" << std::endl;
+		return 1;
 	} catch (NP::InvalidJobReference& ex) {
-		std::cerr << precedence_file << ": bad job reference: job "
+		errors << precedence_file << ": bad job reference: job "
 		          << ex.ref.job << " of task " << ex.ref.task
 			      << " is not part of the job set given in "
 			      << fname
 			      << std::endl;
-		exit(3);
+		return 3;
 	} catch (NP::InvalidAbortParameter& ex) {
-		std::cerr << aborts_file << ": invalid abort parameter: job "
+		errors << aborts_file << ": invalid abort parameter: job "
 		          << ex.ref.job << " of task " << ex.ref.task
 			      << " has an impossible abort time (abort before release)"
 			      << std::endl;
-		exit(4);
+		return 4;
 	} catch (std::exception& ex) {
-		std::cerr << fname << ": '" << ex.what() << "'" << std::endl;
-		exit(1);
+		errors << fname << ": '" << ex.what() << "'" << std::endl;
+		return 1;
 	}
 }
 
+static int process_file(const std::string& fname)
+{
+	return process_file(fname, std::cout, std::cerr);
+}
+
+// how many jobs the job set in the given file has; zero if it cannot be
+// read
+static std::size_t count_jobs(const std::string& fname)
+{
+	try {
+		NP::Mapped_file in(fname);
+		if (NP::is_binary_job_set(in.begin(), in.end()))
+			return NP::binary_job_set_size(in.begin(), in.end());
+		// one job per line after the header
+		auto jobs = std::find(in.begin(), in.end(), '\n');
+		if (jobs == in.end())
+			return 0;
+		return std::count(jobs + 1, in.end(), '\n');
+	} catch (std::exception& ex) {
+		return 0;
+	}
+}
+
+// Analyzes the job sets in the given files side by side, each by a single
+// worker thread, and reports them in order; returns the exit status of the
+// first failed analysis, or zero.
+static int process_files_side_by_side(const std::vector<std::string>& files)
+{
+#ifdef CONFIG_PARALLEL
+	unsigned int num_workers = num_worker_threads ? num_worker_threads
+	                           : std::thread::hardware_concurrency();
+#else
+	// a single-threaded build analyzes one job set at a time
+	unsigned int num_workers = 1;
+#endif
+	num_workers = std::max(1u, std::min<unsigned int>(num_workers,
+	                                                  files.size()));
+	analysis_memory_budget = memory_budget / num_workers;
+
+	struct Report {
+		std::string summary, errors;
+		int status;
+		bool done;
+	};
+	std::vector<Report> reports(files.size());
+	std::mutex lock;
+	std::condition_variable reported;
+	std::atomic<std::size_t> next_file(0);
+	std::atomic<bool> stop(false);
+
+	std::vector<std::thread> workers;
+	for (unsigned int w = 0; w < num_workers; w++)
+		workers.emplace_back([&]() {
+			Processor_clock::measure_calling_thread(true);
+#ifdef CONFIG_PARALLEL
+			// keep the parallel loops of the analysis in this thread
+			tbb::task_arena single(1);
+#endif
+			std::size_t i;
+			while (!stop && (i = next_file++) < files.size()) {
+				std::ostringstream summary, errors;
+				int status;
+#ifdef CONFIG_PARALLEL
+				single.execute([&]() {
+					status = process_file(files[i], summary, errors);
+				});
+#else
+				status = process_file(files[i], summary, errors);
+#endif
+				std::lock_guard<std::mutex> guard(lock);
+				reports[i] = Report{summary.str(), errors.str(), status, true};
+				reported.notify_all();
+			}
+		});
+
+	int status = 0;
+	for (std::size_t i = 0; i < files.size() && !status; i++) {
+		std::unique_lock<std::mutex> guard(lock);
+		reported.wait(guard, [&]() { return reports[i].done; });
+		Report report = std::move(reports[i]);
+		guard.unlock();
+		std::cout << report.summary << std::flush;
+		std::cerr << report.errors;
+		status = report.status;
+	}
+
+	stop = true;
+	for (std::thread& w : workers)
+		w.join();
+	analysis_memory_budget = memory_budget;
+	return status;
+}
+
 static void print_header(){
 	std::cout << "# file name"
 	          << ", schedulable?"
@@ -268,8 +489,17 @@ static void print_header(){
 	          << ", CPU time"
 	          << ", memory"
 	          << ", timeout"
-	          << ", #CPUs"
-	          << std::endl;
+	          << ", #CPUs";
+	if (memory_budget)
+		std::cout << ", out of memory budget"
+		          << ", peak frontier memory";
+	if (want_hash_statistics)
+		std::cout << ", #state lookups"
+		          << ", mean probes"
+		          << ", max probes"
+		          << ", #merge candidates"
+		          << ", #key collisions";
+	std::cout << std::endl;
 }
 
 int main(int argc, char** argv)
@@ -308,6 +538,21 @@ int main(int argc, char** argv)
 	      .help("name of the file that contains the job set's abort actions")
 	      .set_default("");
 
+	parser.add_option("--memory-budget").dest("memory_budget")
+	      .help("maximum memory (in MiB) of two consecutive depths of the "
+	            "state space (global analysis only, zero means no limit)")
+	      .set_default("0");
+
+	parser.add_option("--symmetry-reduction").dest("symmetry_reduction")
+	      .set_default("0").action("store_const").set_const("1")
+	      .help("dispatch jobs that are released together and have the same "
+	            "predecessors only in priority order (global analysis only)");
+
+	parser.add_option("--hash-statistics").dest("hash_statistics")
+	      .set_default("0").action("store_const").set_const("1")
+	      .help("report how the lookup keys of the states spread over the "
+	            "table of states to merge with (global analysis only)");
+
 	parser.add_option("-m", "--multiprocessor").dest("num_processors")
 	      .help("set the number of processors of the platform")
 	      .set_default("1");
@@ -316,6 +561,14 @@ int main(int argc, char** argv)
 	      .help("set the number of worker threads (parallel analysis)")
 	      .set_default("0");
 
+	parser.add_option("--batch-jobs").dest("batch_jobs")
+	      .help("analyze consecutive job sets of at most this many jobs side "
+	            "by side, one per worker thread, instead of one after "
+	            "another with all the threads (zero means never; a "
+	            "--memory-budget is split among them, otherwise their "
+	            "memory use adds up)")
+	      .set_default("0");
+
 	parser.add_option("--header").dest("print_header")
 	      .help("print a column header")
 	      .action("store_const").set_const("1")
@@ -329,6 +582,18 @@ int main(int argc, char** argv)
 	      .action("store_const").set_const("1")
 	      .help("store the best- and worst-case response times (default: off)");
 
+	parser.add_option("-b", "--save-binary").dest("binary").set_default("0")
+	      .action("store_const").set_const("1")
+	      .help("store the job set and its precedence constraints in the "
+	            "binary format, which job set files may also be given in "
+	            "(default: off)");
+
+	parser.add_option("--save-trace").dest("trace").set_default("0")
+	      .action("store_const").set_const("1")
+	      .help("stream the state graph to a binary trace during the "
+	            "analysis, for nptrace to turn into Graphviz dot format "
+	            "(default: off)");
+
 	parser.add_option("-c", "--continue-after-deadline-miss")
 	      .dest("go_on_after_dl").set_default("0")
 	      .action("store_const").set_const("1")
@@ -381,8 +646,34 @@ int main(int argc, char** argv)
 		return 1;
 	}
 
+	memory_budget = (double) options.get("memory_budget") * 1024 * 1024;
+	analysis_memory_budget = memory_budget;
+	if (memory_budget && !want_multiprocessor) {
+		std::cerr << "Error: the memory budget is supported only by the "
+		          << "global analysis (-m)\n" << std::endl;
+		return 1;
+	}
+
+	want_symmetry_reduction = options.get("symmetry_reduction");
+
+	batch_max_jobs = (unsigned long) options.get("batch_jobs");
+
+	want_hash_statistics = options.get("hash_statistics");
+
 	want_rta_file = options.get("rta");
 
+	want_binary_file = options.get("binary");
+
+	want_trace_file = options.get("trace");
+#ifndef CONFIG_PARALLEL
+	if (want_trace_file && !want_multiprocessor) {
+		std::cerr << "Error: traces of the uniprocessor analysis require "
+		          << "parallel analysis (CONFIG_PARALLEL is not set)."
+		          << std::endl;
+		return 3;
+	}
+#endif
+
 	continue_after_dl_miss = options.get("go_on_after_dl");
 
 #ifdef CONFIG_COLLECT_SCHEDULE_GRAPH
@@ -407,14 +698,36 @@ int main(int argc, char** argv)
 	}
 #endif
 
+#ifdef CONFIG_PARALLEL
+	tbb::task_scheduler_init init(
+		num_worker_threads ? num_worker_threads : tbb::task_scheduler_init::automatic);
+#endif
+
 	if (options.get("print_header"))
 		print_header();
 
-	for (auto f : parser.args())
-		process_file(f);
+	const std::vector<std::string>& files = parser.args();
+	for (std::size_t i = 0; i < files.size(); ) {
+		// a run of small job sets is analyzed side by side
+		std::size_t j = i;
+		if (batch_max_jobs && files.size() > 1)
+			while (j < files.size() && files[j] != "-"
+			       && count_jobs(files[j]) <= batch_max_jobs)
+				j++;
+		int status;
+		if (j - i > 1) {
+			status = process_files_side_by_side(
+				std::vector<std::string>(files.begin() + i,
+				                         files.begin() + j));
+			i = j;
+		} else
+			status = process_file(files[i++]);
+		if (status)
+			return status;
+	}
 
-	if (parser.args().empty())
-		process_file("-");
+	if (files.empty())
+		return process_file("-");
 
 	return 0;
 }
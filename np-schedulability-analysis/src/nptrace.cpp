@@ -0,0 +1,167 @@
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "OptionParser.h"
+
+#include "time.hpp"
+#include "mapped_file.hpp"
+#include "trace.hpp"
+
+// Turns (a part of) a schedule-graph trace, as written by
+// nptest --save-trace, into Graphviz dot format.
+
+// command line options
+static unsigned long from_depth = 0;
+static unsigned long to_depth = 0;
+static bool want_to_depth = false;
+static bool want_job = false;
+static unsigned long job_task_id, job_id;
+static bool want_misses = false;
+static bool want_summary = false;
+
+template<class Time>
+static void print_summary(std::ostream &out,
+                          const NP::Graph_trace<Time> &trace)
+{
+	out << "# depth, #states, #edges" << std::endl;
+	for (const auto &d : trace.get_depths())
+		out << d.depth
+		    << ",  " << d.num_states
+		    << ",  " << d.num_edges << std::endl;
+}
+
+template<class Time>
+static void print_graph(std::ostream &out, const NP::Graph_trace<Time> &trace)
+{
+	auto in_range = [&](std::uint64_t state) {
+		auto d = trace.depth_of(state);
+		return d >= from_depth && (!want_to_depth || d <= to_depth);
+	};
+
+	const auto &edges = trace.get_edges();
+	std::vector<bool> with_edge(edges.size(), true);
+	if (want_misses)
+		with_edge = NP::edges_to_deadline_misses(trace);
+
+	// without a filter on the edges, also isolated states are shown
+	bool all_states = !want_misses && !want_job;
+	std::vector<bool> with_state(trace.number_of_states(), false);
+	if (all_states)
+		for (std::uint64_t s = 0; s < trace.number_of_states(); s++)
+			with_state[s] = in_range(s);
+
+	for (std::size_t i = 0; i < edges.size(); i++) {
+		const auto &e = edges[i];
+		const auto &j = trace.get_jobs()[e.job];
+		if (want_job && (j.get_task_id() != job_task_id
+		                 || j.get_job_id() != job_id))
+			with_edge[i] = false;
+		if (!in_range(e.source) || !in_range(e.target))
+			with_edge[i] = false;
+		if (with_edge[i])
+			with_state[e.source] = with_state[e.target] = true;
+	}
+
+	NP::write_dot(out, trace, with_state, with_edge);
+}
+
+template<class Time>
+static void process(std::ostream &out, const NP::Mapped_file &in)
+{
+	NP::Graph_trace<Time> trace(in.begin(), in.end());
+	if (!trace.is_complete())
+		std::cerr << "[!!] Warning: the trace ends with a truncated depth, "
+		          << "which is ignored." << std::endl;
+	if (want_summary)
+		print_summary(out, trace);
+	else
+		print_graph(out, trace);
+}
+
+int main(int argc, char** argv)
+{
+	auto parser = optparse::OptionParser();
+
+	parser.description("Schedule-graph trace to Graphviz dot converter");
+	parser.usage("usage: %prog [OPTIONS]... TRACE FILE");
+
+	parser.add_option("--from-depth").dest("from_depth")
+	      .help("omit the states before the given depth (default: 0)")
+	      .set_default("0");
+
+	parser.add_option("--to-depth").dest("to_depth")
+	      .help("omit the states after the given depth (default: none)");
+
+	parser.add_option("-j", "--job").dest("job").metavar("TASK,JOB")
+	      .help("show only the edges that dispatch the given job, "
+	            "identified by its task ID and job ID");
+
+	parser.add_option("--misses").dest("misses").set_default("0")
+	      .action("store_const").set_const("1")
+	      .help("show only the paths that lead to a possible deadline miss "
+	            "(default: off)");
+
+	parser.add_option("--summary").dest("summary").set_default("0")
+	      .action("store_const").set_const("1")
+	      .help("list the number of states and edges of every depth "
+	            "instead (default: off)");
+
+	parser.add_option("-o", "--output").dest("output")
+	      .help("name of the dot file to write (default: standard output)")
+	      .set_default("-");
+
+	auto options = parser.parse_args(argc, argv);
+
+	from_depth = options.get("from_depth");
+
+	want_to_depth = options.is_set_by_user("to_depth");
+	to_depth = options.get("to_depth");
+
+	want_job = options.is_set_by_user("job");
+	if (want_job) {
+		auto in = std::istringstream((const std::string&) options.get("job"));
+		char comma = 0;
+		if (!(in >> job_task_id >> comma >> job_id) || comma != ',') {
+			std::cerr << "Error: invalid job argument\n" << std::endl;
+			return 1;
+		}
+	}
+
+	want_misses = options.get("misses");
+
+	want_summary = options.get("summary");
+
+	if (parser.args().size() != 1) {
+		parser.print_usage(std::cerr);
+		return 1;
+	}
+	const std::string fname = parser.args()[0];
+
+	try {
+		NP::Mapped_file in(fname);
+
+		auto out_file = std::ofstream();
+		const std::string out_name = options.get("output");
+		if (out_name != "-")
+			out_file.open(out_name, std::ios::out);
+		std::ostream &out = out_name != "-" ?
+			static_cast<std::ostream&>(out_file) :
+			static_cast<std::ostream&>(std::cout);
+
+		if (NP::is_discrete_graph_trace(in.begin(), in.end()))
+			process<dtime_t>(out, in);
+		else
+			process<dense_t>(out, in);
+	} catch (std::ios_base::failure& ex) {
+		std::cerr << fname << ": parse error: " << ex.what() << std::endl;
+		return 1;
+	} catch (std::exception& ex) {
+		std::cerr << fname << ": '" << ex.what() << "'" << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
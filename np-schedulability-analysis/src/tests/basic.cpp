@@ -3,9 +3,11 @@
 
 #include <algorithm>
 #include <iostream>
+#include <map>
 
 #include "index_set.hpp"
 #include "jobs.hpp"
+#include "util.hpp"
 #include "uni/space.hpp"
 
 using namespace NP;
@@ -61,6 +63,58 @@ TEST_CASE("Interval LUT") {
 	CHECK(count == 1);
 }
 
+TEST_CASE("Interval lookup array") {
+	Job<dtime_t>::Job_set jobs{
+		Job<dtime_t>{1, I(0, 0), I(3, 13), 60, 60},
+		Job<dtime_t>{2, I(15, 20), I(1, 2), 25, 25},
+		Job<dtime_t>{3, I(0, 40), I(1, 2), 100, 100},
+	};
+
+	Interval_lookup_table<dtime_t, Job<dtime_t>, &Job<dtime_t>::scheduling_window> lut(I(0, 60), 10);
+	for (const auto &j : jobs)
+		lut.insert(j);
+	Interval_lookup_array<dtime_t, Job<dtime_t>, &Job<dtime_t>::scheduling_window> arr(I(0, 60), 10, jobs);
+
+	// the same buckets, in the same order
+	for (dtime_t t = 0; t < 120; t += 5) {
+		const auto &expected = lut.lookup(t);
+		auto found = arr.lookup(t);
+		REQUIRE(found.size() == expected.size());
+		auto it = found.begin();
+		for (const Job<dtime_t> &j : expected)
+			CHECK(&(it++)->get() == &j);
+	}
+	CHECK(arr.lookup(70).size() == 1);
+	CHECK(arr.lookup(30).size() == 2);
+}
+
+TEST_CASE("Sorted multimap") {
+	std::vector<std::pair<int, int>> entries{
+		{5, 0}, {1, 1}, {5, 2}, {3, 3}, {5, 4}, {9, 5}, {1, 6}};
+	Sorted_multimap<int, int> sorted(entries);
+	std::multimap<int, int> expected(entries.begin(), entries.end());
+
+	REQUIRE(sorted.size() == expected.size());
+	// equal keys keep their order, as in a std::multimap
+	auto e = expected.begin();
+	for (const auto &x : sorted) {
+		CHECK(x.first == e->first);
+		CHECK(x.second == e->second);
+		e++;
+	}
+
+	for (int k = 0; k <= 10; k++) {
+		CHECK(std::distance(sorted.begin(), sorted.lower_bound(k))
+		      == std::distance(expected.begin(), expected.lower_bound(k)));
+		CHECK(std::distance(sorted.begin(), sorted.upper_bound(k))
+		      == std::distance(expected.begin(), expected.upper_bound(k)));
+	}
+
+	Sorted_multimap<int, int> empty;
+	CHECK(empty.lower_bound(3) == empty.end());
+	CHECK(empty.upper_bound(3) == empty.end());
+}
+
 
 TEST_CASE("state space") {
 
@@ -140,5 +194,85 @@ TEST_CASE("[basic] index set")
 	CHECK(all.includes(a));
 	CHECK(all.includes(b));
 	CHECK(!all.includes(c));
+
+	// some + 30 == all + 20 == (all - 10) + 10
+	NP::Index_set others;
+	others.add(20);
+	others.add(30);
+	CHECK(some.equals_with(30, all, 20));
+	CHECK(some.equals_with(30, others, 10));
+	CHECK(!some.equals_with(40, others, 10));
+	CHECK(!some.equals_with(30, others, 40));
+	CHECK(empty.equals_with(1000, empty, 1000));
+	CHECK(!empty.equals_with(1000, empty, 999));
+}
+
+TEST_CASE("[basic] bump arena")
+{
+	NP::Bump_arena arena(256);
+
+	auto a = static_cast<char *>(arena.allocate(3, 1));
+	auto b = static_cast<std::uint64_t *>(arena.allocate(16, 8));
+	CHECK(reinterpret_cast<std::uintptr_t>(b) % 8 == 0);
+	CHECK(reinterpret_cast<char *>(b) >= a + 3);
+	CHECK(arena.bytes_reserved() == 256);
+
+	// larger than a chunk
+	arena.allocate(1000, 8);
+	CHECK(arena.bytes_reserved() > 1000);
+
+	// released memory is handed out again
+	auto mark = arena.mark();
+	auto c = arena.allocate(64, 8);
+	arena.release(mark);
+	CHECK(arena.allocate(64, 8) == c);
+
+	auto reserved = arena.bytes_reserved();
+	NP::Index_set small;
+	NP::Index_set large{small, 4000, &arena};
+	CHECK(large.contains(4000));
+	CHECK(large.size() == 1);
+	CHECK(arena.bytes_reserved() > reserved);
+}
+
+TEST_CASE("[basic] index set beyond the inline words")
+{
+	NP::Index_set small;
+	small.add(3);
+	small.add(64);
+
+	NP::Index_set large{small, 1000};
+	NP::Index_set larger{large, 40000};
+
+	CHECK(large.contains(3));
+	CHECK(large.contains(64));
+	CHECK(large.contains(1000));
+	CHECK(!large.contains(999));
+	CHECK(!large.contains(40000));
+	CHECK(larger.contains(40000));
+	CHECK(larger.size() == 4);
+
+	CHECK(small.is_subset_of(large));
+	CHECK(large.is_subset_of(larger));
+	CHECK(!larger.is_subset_of(large));
+	CHECK(!large.is_subset_of(small));
+
+	// equal contents stored in a different number of words
+	NP::Index_set grown;
+	grown.add(40000);
+	grown.add(3);
+	grown.add(64);
+	grown.add(1000);
+	CHECK(grown == larger);
+	CHECK(grown.hash() == larger.hash());
+	CHECK(grown != large);
+
+	NP::Index_set same{small, 3};
+	CHECK(same == small);
+	CHECK(same.hash() == small.hash());
+
+	NP::Index_set diff{large, larger};
+	CHECK(diff.size() == 1);
+	CHECK(diff.contains(40000));
 }
 
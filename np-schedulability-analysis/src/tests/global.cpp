@@ -406,3 +406,239 @@ TEST_CASE("[global] explore across bucket boundaries") {
 	CHECK(space.number_of_edges() == 3);
 }
 
+
+TEST_CASE("[global] memory budget") {
+	auto in = std::istringstream(fig1a_jobs_file);
+	auto jobs = NP::parse_file<dtime_t>(in);
+
+	NP::Scheduling_problem<dtime_t> prob{jobs, 2};
+	NP::Analysis_options opts;
+
+	auto space = NP::Global::State_space<dtime_t>::explore(prob, opts);
+	CHECK(space.is_schedulable());
+	CHECK_FALSE(space.was_out_of_memory());
+	CHECK(space.peak_frontier_memory() > 0);
+
+	// the peak is measured between depths, allow some slack within them
+	opts.memory_budget = 2 * space.peak_frontier_memory();
+	auto enough = NP::Global::State_space<dtime_t>::explore(prob, opts);
+	CHECK(enough.is_schedulable());
+	CHECK_FALSE(enough.was_out_of_memory());
+
+	opts.memory_budget = 1;
+	auto starved = NP::Global::State_space<dtime_t>::explore(prob, opts);
+	CHECK_FALSE(starved.is_schedulable());
+	CHECK(starved.was_out_of_memory());
+	CHECK_FALSE(starved.was_timed_out());
+}
+
+TEST_CASE("[global] symmetry reduction") {
+	// three forks of the same source, released together
+	NP::Job<dtime_t>::Job_set jobs{
+		NP::Job<dtime_t>{1, I( 0,  0), I(1, 2), 40, 1, 1},
+		NP::Job<dtime_t>{2, I( 0,  0), I(3, 5), 40, 2, 1},
+		NP::Job<dtime_t>{3, I( 0,  0), I(3, 5), 40, 2, 1},
+		NP::Job<dtime_t>{4, I( 0,  0), I(2, 6), 40, 3, 1},
+		NP::Job<dtime_t>{5, I( 0,  3), I(1, 4), 40, 1, 2},
+		NP::Job<dtime_t>{6, I(10, 10), I(2, 3), 40, 1, 2},
+	};
+	NP::Precedence_constraints edges{
+		{NP::JobID{1, 1}, NP::JobID{2, 1}},
+		{NP::JobID{1, 1}, NP::JobID{3, 1}},
+		{NP::JobID{1, 1}, NP::JobID{4, 1}},
+	};
+
+	for (unsigned int num_cpus = 1; num_cpus <= 3; num_cpus++) {
+		NP::Scheduling_problem<dtime_t> prob{jobs, edges, num_cpus};
+		NP::Analysis_options opts;
+
+		auto space = NP::Global::State_space<dtime_t>::explore(prob, opts);
+		opts.symmetry_reduction = true;
+		auto reduced = NP::Global::State_space<dtime_t>::explore(prob, opts);
+
+		CHECK(space.is_schedulable() == reduced.is_schedulable());
+		CHECK(space.number_of_states() == reduced.number_of_states());
+		CHECK(space.number_of_edges() == reduced.number_of_edges());
+		for (const auto &j : jobs)
+			CHECK(space.get_finish_times(j) == reduced.get_finish_times(j));
+	}
+}
+
+TEST_CASE("[global] schedulability only") {
+	auto in = std::istringstream(fig1a_jobs_file);
+	auto jobs = NP::parse_file<dtime_t>(in);
+
+	NP::Precedence_constraints edges{
+		{NP::JobID{1, 1}, NP::JobID{7, 2}},
+		{NP::JobID{7, 2}, NP::JobID{9, 3}},
+	};
+
+	for (unsigned int num_cpus = 1; num_cpus <= 2; num_cpus++) {
+		NP::Scheduling_problem<dtime_t> prob{jobs, edges, num_cpus};
+		NP::Analysis_options opts;
+
+		auto space = NP::Global::State_space<dtime_t>::explore(prob, opts);
+		opts.schedulability_only = true;
+		auto fast = NP::Global::State_space<dtime_t>::explore(prob, opts);
+
+		CHECK(space.is_schedulable() == fast.is_schedulable());
+		if (space.is_schedulable())
+			CHECK(space.number_of_states() == fast.number_of_states());
+		else
+			CHECK(space.number_of_states() >= fast.number_of_states());
+
+		// only the jobs with successors keep their finish times
+		CHECK(fast.get_finish_times(jobs[0]) == space.get_finish_times(jobs[0]));
+		CHECK(fast.get_finish_times(jobs[8]).until() == inf);
+	}
+}
+
+TEST_CASE("[global] response-time bookkeeping") {
+	auto in = std::istringstream(fig1a_jobs_file);
+	auto jobs = NP::parse_file<dtime_t>(in);
+
+	NP::Precedence_constraints edges{
+		{NP::JobID{1, 1}, NP::JobID{7, 2}},
+		{NP::JobID{7, 2}, NP::JobID{9, 3}},
+	};
+
+	for (unsigned int num_cpus = 1; num_cpus <= 3; num_cpus++) {
+		NP::Scheduling_problem<dtime_t> prob{jobs, edges, num_cpus};
+		NP::Analysis_options opts;
+
+		auto space = NP::Global::State_space<dtime_t>::explore(prob, opts);
+		auto hashed = NP::Global::State_space<dtime_t,
+			NP::Global::Hashed_response_times<dtime_t>>::explore(prob, opts);
+
+		CHECK(space.is_schedulable() == hashed.is_schedulable());
+		CHECK(space.number_of_states() == hashed.number_of_states());
+		for (const auto& j : jobs)
+			CHECK(space.get_finish_times(j) == hashed.get_finish_times(j));
+	}
+}
+
+TEST_CASE("[global] state key table") {
+	NP::Global::Key_table<std::vector<int>> table;
+
+	// same shard and same home slot: every key probes all the previous ones
+	for (int i = 0; i < 100; i++)
+		table.with_value((NP::hash_value_t) i << 32,
+			[&](std::vector<int>& v) { v.push_back(i); });
+
+	auto stats = table.statistics();
+	CHECK(stats.lookups == 100);
+	CHECK(stats.max_probe == 100);
+
+	// the values survive the growth of the table
+	for (int i = 0; i < 100; i++)
+		CHECK(table.with_value((NP::hash_value_t) i << 32,
+			[&](std::vector<int>& v) { return v; }) == std::vector<int>{i});
+
+	table.clear();
+	CHECK(table.with_value(0, [](std::vector<int>& v) { return v.empty(); }));
+}
+
+TEST_CASE("[global] state key statistics") {
+	auto in = std::istringstream(fig1a_jobs_file);
+	auto jobs = NP::parse_file<dtime_t>(in);
+
+	for (unsigned int num_cpus = 1; num_cpus <= 3; num_cpus++) {
+		auto space = NP::Global::State_space<dtime_t>::explore(jobs, num_cpus);
+		auto stats = space.hash_statistics();
+
+		// one lookup per state created, merged or not
+		CHECK(stats.lookups >= space.number_of_states() - 1);
+		CHECK(stats.probes >= stats.lookups);
+		CHECK(stats.collisions == 0);
+	}
+}
+
+// jobs of periodic tasks {period, least cost, cost}, numbered by task and
+// then by release, as in the DAG workloads of the optimizer
+static NP::Scheduling_problem<dtime_t>::Workload periodic_jobs(
+	const std::vector<std::vector<dtime_t>>& tasks, dtime_t horizon)
+{
+	NP::Scheduling_problem<dtime_t>::Workload jobs;
+	unsigned long id = 0;
+	for (unsigned long t = 0; t < tasks.size(); t++)
+		for (dtime_t r = 0; r < horizon; r += tasks[t][0])
+			jobs.push_back(NP::Job<dtime_t>{id++,
+				I(r, r + 2), I(tasks[t][1], tasks[t][2]),
+				r + tasks[t][0], r + tasks[t][0], t});
+	return jobs;
+}
+
+static void check_same_analysis(
+	const NP::Global::State_space<dtime_t>& space,
+	const NP::Global::State_space<dtime_t>& fresh,
+	const NP::Scheduling_problem<dtime_t>::Workload& jobs)
+{
+	CHECK(space.is_schedulable() == fresh.is_schedulable());
+	CHECK(space.number_of_states() == fresh.number_of_states());
+	CHECK(space.number_of_edges() == fresh.number_of_edges());
+	CHECK(space.max_exploration_front_width()
+	      == fresh.max_exploration_front_width());
+	for (const auto& j : jobs)
+		CHECK(space.get_finish_times(j) == fresh.get_finish_times(j));
+}
+
+TEST_CASE("[global] resume from checkpoints") {
+	typedef NP::Global::State_space<dtime_t> Space;
+	std::vector<std::vector<dtime_t>> tasks{{10, 2, 3}, {20, 3, 5}, {40, 6, 9}};
+
+	for (unsigned int num_cpus = 1; num_cpus <= 2; num_cpus++) {
+		NP::Analysis_options opts;
+		opts.checkpoints = 8;
+		auto jobs = periodic_jobs(tasks, 80);
+		NP::Scheduling_problem<dtime_t> prob{jobs, num_cpus};
+		auto first = Space::explore(prob, opts);
+		CHECK(first.resumed_depth() == 0);
+		auto checkpoints = first.take_checkpoints();
+		CHECK(!checkpoints.empty());
+
+		// the same workload: resumed from the deepest checkpoint
+		auto again = Space::explore(prob, opts, &checkpoints);
+		CHECK(again.resumed_depth() == checkpoints.checkpoints.back().depth);
+		check_same_analysis(again, first, jobs);
+
+		// a job released late is longer now
+		auto longer = jobs;
+		longer[longer.size() - 1] = NP::Job<dtime_t>{jobs.back().get_job_id(),
+			I(40, 42), I(6, 10), 80, 80, 2};
+		NP::Scheduling_problem<dtime_t> prob_longer{longer, num_cpus};
+		auto resumed = Space::explore(prob_longer, opts, &checkpoints);
+		CHECK(resumed.resumed_depth() > 0);
+		check_same_analysis(resumed, Space::explore(prob_longer, NP::Analysis_options()),
+		                    longer);
+
+		// and resuming again from the checkpoints of the resumed analysis,
+		// without the last job of the first task: the IDs of the later
+		// jobs shift
+		auto checkpoints_longer = resumed.take_checkpoints();
+		auto fewer = periodic_jobs(tasks, 80);
+		fewer.erase(fewer.begin() + 7);
+		for (std::size_t i = 7; i < fewer.size(); i++)
+			fewer[i] = NP::Job<dtime_t>{i, fewer[i].arrival_window(),
+				fewer[i].get_cost(), fewer[i].get_deadline(),
+				fewer[i].get_priority(), fewer[i].get_task_id()};
+		fewer.back() = NP::Job<dtime_t>{fewer.size() - 1, I(40, 42), I(6, 10),
+			80, 80, 2};
+		NP::Scheduling_problem<dtime_t> prob_fewer{fewer, num_cpus};
+		auto resumed_fewer = Space::explore(prob_fewer, opts,
+		                                    &checkpoints_longer);
+		CHECK(resumed_fewer.resumed_depth() > 0);
+		check_same_analysis(resumed_fewer,
+		                    Space::explore(prob_fewer, NP::Analysis_options()),
+		                    fewer);
+
+		// a change at time zero leaves nothing to reuse
+		auto first_longer = jobs;
+		first_longer[0] = NP::Job<dtime_t>{0, I(0, 2), I(2, 4), 10, 10, 0};
+		NP::Scheduling_problem<dtime_t> prob_first{first_longer, num_cpus};
+		auto scratch = Space::explore(prob_first, opts, &checkpoints);
+		CHECK(scratch.resumed_depth() == 0);
+		check_same_analysis(scratch,
+		                    Space::explore(prob_first, NP::Analysis_options()),
+		                    first_longer);
+	}
+}
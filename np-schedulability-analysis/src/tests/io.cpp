@@ -4,6 +4,7 @@
 #include <sstream>
 
 #include "io.hpp"
+#include "mapped_file.hpp"
 
 const std::string one_line = "       920,          6,              50000.0,              50010.0,   23.227497252002234,    838.6724123730141,              60000.0,                    1";
 
@@ -154,3 +155,98 @@ TEST_CASE("[parser] valid precedence reference") {
 	// dummy check; real check is that previous line didn't throw an exception
 	CHECK(true);
 }
+
+static std::vector<NP::Job<dense_t>> parse_in_memory(const std::string &text)
+{
+	return NP::parse_file<dense_t>(text.data(), text.data() + text.size());
+}
+
+TEST_CASE("[parser] in-memory file parser") {
+	auto in = std::istringstream(four_lines);
+	auto expected = NP::parse_file<dense_t>(in);
+
+	auto jobs = parse_in_memory(four_lines);
+
+	REQUIRE(jobs.size() == expected.size());
+	for (std::size_t i = 0; i < jobs.size(); i++) {
+		CHECK(jobs[i].get_id() == expected[i].get_id());
+		CHECK(jobs[i].arrival_window() == expected[i].arrival_window());
+		CHECK(jobs[i].get_cost() == expected[i].get_cost());
+		CHECK(jobs[i].get_deadline() == expected[i].get_deadline());
+		CHECK(jobs[i].get_priority() == expected[i].get_priority());
+	}
+
+	// no trailing line break, blank lines, extra columns
+	CHECK(parse_in_memory("header\n1, 2, 3, 4, 5, 6, 7, 8").size() == 1);
+	CHECK(parse_in_memory("header\n\n1 2 3 4 5 6 7 8, 9\n \n").size() == 1);
+	CHECK(parse_in_memory("header only").empty());
+}
+
+TEST_CASE("[parser] in-memory file parser exceptions") {
+	REQUIRE_THROWS_AS(parse_in_memory("header\n" + bad_line),
+	                  std::ios_base::failure);
+	// too few fields on a line
+	REQUIRE_THROWS_AS(parse_in_memory("header\n1, 2, 3, 4, 5, 6, 7\n8\n"),
+	                  std::ios_base::failure);
+	REQUIRE_THROWS_AS(NP::parse_file<dtime_t>(four_lines.data(),
+	                                          four_lines.data()
+	                                          + four_lines.size()),
+	                  std::ios_base::failure);
+}
+
+TEST_CASE("[parser] in-memory precedence file") {
+	auto in = std::istringstream(precedence_file);
+	auto expected = NP::parse_dag_file(in);
+
+	auto dag = NP::parse_dag_file(precedence_file.data(),
+	                              precedence_file.data()
+	                              + precedence_file.size());
+
+	CHECK(dag == expected);
+
+	const std::string bad = "header\n" + bad_precedence_line;
+	REQUIRE_THROWS_AS(NP::parse_dag_file(bad.data(), bad.data() + bad.size()),
+	                  std::ios_base::failure);
+	const std::string bad2 = "header\n" + bad_precedence_line2;
+	REQUIRE_THROWS_AS(NP::parse_dag_file(bad2.data(),
+	                                     bad2.data() + bad2.size()),
+	                  std::ios_base::failure);
+}
+
+TEST_CASE("[parser] binary job set") {
+	auto dag_in = std::istringstream(sequential_task_prec_file);
+	auto dag = NP::parse_dag_file(dag_in);
+	auto jobs = parse_in_memory(four_lines);
+
+	auto out = std::ostringstream();
+	NP::write_binary_job_set<dense_t>(out, jobs, dag);
+	auto bytes = std::istringstream(out.str());
+	NP::Mapped_file file(bytes);
+
+	REQUIRE(NP::is_binary_job_set(file.begin(), file.end()));
+	CHECK(!NP::is_binary_job_set(four_lines.data(),
+	                             four_lines.data() + four_lines.size()));
+
+	std::vector<NP::Job<dense_t>> read_jobs;
+	NP::Precedence_constraints read_dag;
+	NP::parse_binary_job_set<dense_t>(file.begin(), file.end(),
+	                                  read_jobs, read_dag);
+
+	CHECK(read_dag == dag);
+	REQUIRE(read_jobs.size() == jobs.size());
+	for (std::size_t i = 0; i < jobs.size(); i++) {
+		CHECK(read_jobs[i].get_id() == jobs[i].get_id());
+		CHECK(read_jobs[i].arrival_window() == jobs[i].arrival_window());
+		CHECK(read_jobs[i].get_cost() == jobs[i].get_cost());
+		CHECK(read_jobs[i].get_deadline() == jobs[i].get_deadline());
+		CHECK(read_jobs[i].get_priority() == jobs[i].get_priority());
+	}
+
+	std::vector<NP::Job<dtime_t>> discrete_jobs;
+	REQUIRE_THROWS_AS(NP::parse_binary_job_set<dtime_t>(
+		file.begin(), file.end(), discrete_jobs, read_dag),
+		std::ios_base::failure);
+	REQUIRE_THROWS_AS(NP::parse_binary_job_set<dense_t>(
+		file.begin(), file.end() - 1, read_jobs, read_dag),
+		std::ios_base::failure);
+}
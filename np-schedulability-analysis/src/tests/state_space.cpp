@@ -4,6 +4,10 @@
 
 #include "uni/space.hpp"
 
+#ifdef CONFIG_PARALLEL
+#include "tbb/task_arena.h"
+#endif
+
 using namespace NP;
 
 static const auto inf = Time_model::constants<dtime_t>::infinity();
@@ -397,3 +401,54 @@ TEST_CASE("[NP state space] start times satisfy work-conserving property")
         CHECK(space.get_finish_times(j1) == I(2, 10));
     }
 }
+
+TEST_CASE("[NP state space] same exploration as the serial explorer with any number of workers")
+{
+	// periodic tasks with release jitter, so that the depths are wide
+	// enough to be merged by shards
+	const dtime_t tasks[][2] = {{10, 1}, {15, 2}, {20, 2}, {24, 2},
+	                            {30, 3}, {40, 3}, {60, 4}, {120, 8}};
+	Uniproc::State_space<dtime_t>::Workload jobs;
+	unsigned long id = 0;
+	for (unsigned long t = 0; t < 8; t++)
+		for (dtime_t r = 0; r < 600; r += tasks[t][0], id++) {
+			dtime_t jitter = (id * 7) % 31;
+			jobs.push_back(Job<dtime_t>{id, I(r, r + jitter),
+				I(1, tasks[t][1]), r + tasks[t][0], tasks[t][0], t});
+		}
+
+	Scheduling_problem<dtime_t> prob{jobs};
+	Analysis_options opts;
+	opts.early_exit = false;
+
+	for (bool naive : {false, true}) {
+		opts.be_naive = naive;
+		// the naive exploration is too large for the whole horizon
+		opts.max_depth = naive ? 8 : 0;
+
+#ifdef CONFIG_PARALLEL
+		tbb::task_arena single(1);
+		auto one = single.execute([&]() {
+			return Uniproc::State_space<dtime_t>::explore(prob, opts);
+		});
+#else
+		auto one = Uniproc::State_space<dtime_t>::explore(prob, opts);
+#endif
+		// as many workers as there are cores
+		auto many = Uniproc::State_space<dtime_t>::explore(prob, opts);
+		// one state at a time, as in a single-threaded build
+		auto serial = Uniproc::State_space<dtime_t>::explore_serially(prob, opts);
+
+		CHECK(one.number_of_states() > jobs.size());
+		for (const auto *space : {&one, &many}) {
+			CHECK(space->is_schedulable() == serial.is_schedulable());
+			CHECK(space->number_of_states() == serial.number_of_states());
+			CHECK(space->number_of_edges() == serial.number_of_edges());
+			CHECK(space->max_exploration_front_width()
+			      == serial.max_exploration_front_width());
+			for (const auto& j : jobs)
+				CHECK(space->get_finish_times(j)
+				      == serial.get_finish_times(j));
+		}
+	}
+}
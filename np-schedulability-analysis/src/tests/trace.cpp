@@ -0,0 +1,227 @@
+#include "doctest.h"
+
+#include <iostream>
+#include <sstream>
+
+#include "io.hpp"
+#include "trace.hpp"
+#include "uni/space.hpp"
+#include "global/space.hpp"
+
+#ifdef CONFIG_PARALLEL
+#include "tbb/task_arena.h"
+#endif
+
+const std::string trace_jobs_file =
+"   Task ID,     Job ID,          Arrival min,          Arrival max,             Cost min,             Cost max,             Deadline,             Priority\n"
+"1, 1,  0,  0, 1,  2, 10, 10\n"
+"1, 2, 10, 10, 1,  2, 20, 20\n"
+"1, 3, 20, 20, 1,  2, 30, 30\n"
+"1, 4, 30, 30, 1,  2, 40, 40\n"
+"1, 5, 40, 40, 1,  2, 50, 50\n"
+"1, 6, 50, 50, 1,  2, 60, 60\n"
+"2, 7,  0,  0, 7,  8, 30, 30\n"
+"2, 8, 30, 30, 7,  7, 60, 60\n"
+"3, 9,  0,  0, 3, 13, 60, 60\n";
+
+// checks the structure of the trace, and that its edges account for the
+// finish times found by the analysis
+template<class Space>
+static void check_trace(const NP::Graph_trace<dtime_t> &trace,
+                        const Space &space,
+                        const NP::Job<dtime_t>::Job_set &jobs)
+{
+	CHECK(trace.is_complete());
+	REQUIRE(trace.get_jobs().size() == jobs.size());
+	for (std::size_t i = 0; i < jobs.size(); i++)
+		CHECK(trace.get_jobs()[i].get_id() == jobs[i].get_id());
+
+	const auto &depths = trace.get_depths();
+	REQUIRE(!depths.empty());
+	CHECK(depths[0].num_states == 1);
+	CHECK(depths[0].num_edges == 0);
+	std::uint64_t num_states = 0, num_edges = 0;
+	for (std::size_t d = 0; d < depths.size(); d++) {
+		CHECK(depths[d].depth == d);
+		CHECK(depths[d].first_state == num_states);
+		CHECK(depths[d].first_edge == num_edges);
+		num_states += depths[d].num_states;
+		num_edges += depths[d].num_edges;
+	}
+	CHECK(trace.number_of_states() == num_states);
+	CHECK(trace.get_edges().size() == space.number_of_edges());
+
+	std::vector<Interval<dtime_t>> finish_times(jobs.size(),
+	                                            Interval<dtime_t>{0, 0});
+	std::vector<bool> dispatched(jobs.size(), false);
+	for (const auto &e : trace.get_edges()) {
+		CHECK(trace.depth_of(e.target) == trace.depth_of(e.source) + 1);
+		if (dispatched[e.job])
+			finish_times[e.job].widen(e.finish_range);
+		else
+			finish_times[e.job] = e.finish_range;
+		dispatched[e.job] = true;
+	}
+	for (std::size_t i = 0; i < jobs.size(); i++) {
+		CHECK(dispatched[i]);
+		CHECK(finish_times[i] == space.get_finish_times(jobs[i]));
+	}
+}
+
+TEST_CASE("[trace] global analysis") {
+	auto in = std::istringstream(trace_jobs_file);
+	auto jobs = NP::parse_file<dtime_t>(in);
+
+	NP::Scheduling_problem<dtime_t> prob{jobs, 2};
+	NP::Analysis_options opts;
+	auto out = std::ostringstream();
+	opts.graph_trace = &out;
+
+	auto space = NP::Global::State_space<dtime_t>::explore(prob, opts);
+	CHECK(space.is_schedulable());
+
+	auto bytes = out.str();
+	NP::Graph_trace<dtime_t> trace(bytes.data(), bytes.data() + bytes.size());
+	CHECK(NP::is_discrete_graph_trace(bytes.data(),
+	                                  bytes.data() + bytes.size()));
+	CHECK(trace.kind() == NP::Trace_states::global);
+	CHECK(trace.number_of_processors() == 2);
+	check_trace(trace, space, jobs);
+	CHECK(trace.get_depths().back().depth == jobs.size());
+#ifdef CONFIG_COLLECT_SCHEDULE_GRAPH
+	CHECK(trace.get_edges().size() == space.get_edges().size());
+#endif
+
+	// no edge leads to a deadline miss
+	auto to_miss = NP::edges_to_deadline_misses(trace);
+	CHECK(std::count(to_miss.begin(), to_miss.end(), true) == 0);
+
+	// the states are labeled as in the graph of the analysis
+	auto dot = std::ostringstream();
+	std::vector<bool> all_states(trace.number_of_states(), true);
+	std::vector<bool> all_edges(trace.get_edges().size(), true);
+	NP::write_dot(dot, trace, all_states, all_edges);
+	CHECK(dot.str().find("S0[label=\"S0: [0, 0] [0, 0] \\n{}\"];")
+	      != std::string::npos);
+	CHECK(dot.str().find("color=Red") == std::string::npos);
+
+#ifdef CONFIG_PARALLEL
+	// the states are numbered alike by any number of worker threads
+	auto single_out = std::ostringstream();
+	opts.graph_trace = &single_out;
+	tbb::task_arena single(1);
+	single.execute([&]() {
+		NP::Global::State_space<dtime_t>::explore(prob, opts);
+	});
+	CHECK(single_out.str() == bytes);
+#endif
+}
+
+TEST_CASE("[trace] naive global analysis") {
+	auto in = std::istringstream(trace_jobs_file);
+	auto jobs = NP::parse_file<dtime_t>(in);
+
+	NP::Scheduling_problem<dtime_t> prob{jobs, 2};
+	NP::Analysis_options opts;
+	opts.be_naive = true;
+	auto out = std::ostringstream();
+	opts.graph_trace = &out;
+
+	auto space = NP::Global::State_space<dtime_t>::explore(prob, opts);
+	auto bytes = out.str();
+	NP::Graph_trace<dtime_t> trace(bytes.data(), bytes.data() + bytes.size());
+	check_trace(trace, space, jobs);
+
+#ifdef CONFIG_PARALLEL
+	// unmerged states with the same contents are numbered alike by any
+	// number of worker threads, too
+	auto single_out = std::ostringstream();
+	opts.graph_trace = &single_out;
+	tbb::task_arena single(1);
+	single.execute([&]() {
+		NP::Global::State_space<dtime_t>::explore(prob, opts);
+	});
+	CHECK(single_out.str() == bytes);
+#endif
+}
+
+TEST_CASE("[trace] truncated and foreign traces") {
+	auto in = std::istringstream(trace_jobs_file);
+	auto jobs = NP::parse_file<dtime_t>(in);
+
+	NP::Scheduling_problem<dtime_t> prob{jobs, 2};
+	NP::Analysis_options opts;
+	auto out = std::ostringstream();
+	opts.graph_trace = &out;
+	NP::Global::State_space<dtime_t>::explore(prob, opts);
+	auto bytes = out.str();
+
+	NP::Graph_trace<dtime_t> whole(bytes.data(), bytes.data() + bytes.size());
+	NP::Graph_trace<dtime_t> cut(bytes.data(),
+	                             bytes.data() + bytes.size() - 5);
+	CHECK(!cut.is_complete());
+	CHECK(cut.get_depths().size() == whole.get_depths().size() - 1);
+	CHECK(cut.number_of_states()
+	      == whole.number_of_states()
+	         - whole.get_depths().back().num_states);
+
+	REQUIRE_THROWS_AS(NP::Graph_trace<dense_t>(bytes.data(),
+	                                           bytes.data() + bytes.size()),
+	                  std::ios_base::failure);
+
+	auto binary = std::ostringstream();
+	NP::write_binary_job_set<dtime_t>(binary, jobs, NP::Precedence_constraints());
+	auto job_set = binary.str();
+	CHECK(!NP::is_graph_trace(job_set.data(),
+	                          job_set.data() + job_set.size()));
+	REQUIRE_THROWS_AS(NP::Graph_trace<dtime_t>(job_set.data(),
+	                                           job_set.data() + job_set.size()),
+	                  std::ios_base::failure);
+}
+
+#ifdef CONFIG_PARALLEL
+
+TEST_CASE("[trace] uniprocessor analysis") {
+	auto in = std::istringstream(trace_jobs_file);
+	auto jobs = NP::parse_file<dtime_t>(in);
+
+	NP::Scheduling_problem<dtime_t> prob{jobs};
+	NP::Analysis_options opts;
+	opts.early_exit = false;
+	auto out = std::ostringstream();
+	opts.graph_trace = &out;
+
+	auto space = NP::Uniproc::State_space<dtime_t>::explore(prob, opts);
+	CHECK(!space.is_schedulable());
+
+	auto bytes = out.str();
+	NP::Graph_trace<dtime_t> trace(bytes.data(), bytes.data() + bytes.size());
+	CHECK(trace.kind() == NP::Trace_states::uniproc);
+	check_trace(trace, space, jobs);
+	// all states are in the trace, the final one included
+	CHECK(trace.number_of_states() == space.number_of_states());
+
+	// J2 may miss its deadline after J9, on the path S0 S1 S2 S3 S5 of
+	// Figure 1(b)
+	auto to_miss = NP::edges_to_deadline_misses(trace);
+	CHECK(std::count(to_miss.begin(), to_miss.end(), true) == 4);
+	// exactly the edges that miss a deadline, or continue with such edges
+	const auto &edges = trace.get_edges();
+	std::vector<bool> continues(trace.number_of_states(), false);
+	for (std::size_t i = 0; i < edges.size(); i++)
+		if (to_miss[i])
+			continues[edges[i].source] = true;
+	for (std::size_t i = 0; i < edges.size(); i++)
+		CHECK(to_miss[i] == (trace.deadline_miss_possible(edges[i])
+		                     || continues[edges[i].target]));
+
+	auto dot = std::ostringstream();
+	std::vector<bool> all_states(trace.number_of_states(), true);
+	NP::write_dot(dot, trace, all_states, to_miss);
+	CHECK(dot.str().find("S0[label=\"S0: [0, 0]\\nER=0\"];")
+	      != std::string::npos);
+	CHECK(dot.str().find("T1 J2\\nDL=20\\nES=11\\nLS=22\\nEF=12\\nLF=24\","
+	                     "color=Red") != std::string::npos);
+}
+
+#endif
@@ -1,4 +1,5 @@
 #pragma once
+#include "sources/BatchRunner.h"
 #include "sources/BatchTestutils.h"
 #include "sources/ControlOptimization/ControlIfoptSpec.h"
 #include "sources/ControlOptimization/ControlOptimize.h"
@@ -158,55 +159,84 @@ void BatchOptimize(int Nn = 5) {
     std::vector<double> rtaCallTime;
     double worstObjRatio = -100;
     std::string worstFile = "";
-    for (const auto &file : ReadFilesInDirectory(pathDataset)) {
+    std::vector<std::string> files = ReadFilesInDirectory(pathDataset);
+
+    // optimize all the task sets first, the baseline results are read later
+    std::vector<size_t> jobFileIndex;
+    std::vector<double> jobCost;
+    for (size_t i = 0; i < files.size(); i++) {
+        if (TargetFileType(files[i]) == 0) {
+            jobFileIndex.push_back(i);
+            jobCost.push_back(EstimateJobCost(pathDataset + files[i]));
+        }
+    }
+    auto optimizeFile = [&](size_t jobIndex) {
+        const std::string &file = files[jobFileIndex[jobIndex]];
+        std::string path = pathDataset + file;
+        std::cout << file << std::endl;
+        // every task set is optimized with a fresh context
+        OptimizationContext context;
+        OptimizationContextScope scope(context);
+        context.SetTimeLimit(batchJobTimeLimit);
+        TaskSet tasks;
+        VectorDynamic coeff;
+        std::tie(tasks, coeff) = ReadControlCase(path);
+        std::vector<bool> maskForElimination(tasks.size(),
+                                             false);  // TODO: try *2 to ?
+        auto start = std::chrono::high_resolution_clock::now();
+        std::pair<VectorDynamic, double> res;
+        if (optimizerType <= 4)
+            res = OptimizeTaskSetIterative<FactorGraphType, TaskSetNormal,
+                                           Schedul_Analysis>(
+                tasks, coeff, maskForElimination, TaskSetNormal(tasks),
+                context);
+        // NOTE: currently, only use this method for control_LL
+        // experiment
+        else if (optimizerType == 6) {
+            TaskSetNormal tasksN(tasks);
+            res = OptimizeControlIfopt<TaskSetNormal, RTA_LL>(tasksN, coeff);
+        }
+        auto stop = std::chrono::high_resolution_clock::now();
+        auto duration =
+            std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
+
+        BatchJobResult jobRes;
+        jobRes.res = res.second;
+        jobRes.timeTaken = double(duration.count()) / 1e6;
+        jobRes.rtaCall = context.rtaControl;
+        jobRes.taskNumber = tasks.size();
+        jobRes.optimized = true;
+        jobRes.timeOut = context.TimeOut();
+        // check schedulability
+        UpdateTaskSetPeriod(tasks, res.first);
+        RTA_LL r(tasks);
+        jobRes.schedulable = r.CheckSchedulability();
+        return jobRes;
+    };
+    std::vector<BatchJobResult> jobResults =
+        RunBatchParallel<BatchJobResult>(jobCost, optimizeFile);
+
+    // aggregate in the directory order
+    size_t jobIndex = 0;
+    for (const auto &file : files) {
         // if (debugMode)
         int type = TargetFileType(file);
 
-        std::string path = pathDataset + file;
         switch (type) {
-            case 0:  // perform optimization
+            case 0:  // optimization result
             {
-                std::cout << file << std::endl;
-                TaskSet tasks;
-                VectorDynamic coeff;
-                std::tie(tasks, coeff) = ReadControlCase(path);
-                N = tasks.size();
-                std::vector<bool> maskForElimination(
-                    tasks.size(), false);  // TODO: try *2 to ?
-                ResetCallingTimes();
-                auto start = std::chrono::high_resolution_clock::now();
-                std::pair<VectorDynamic, double> res;
-                if (optimizerType <= 4)
-                    res =
-                        OptimizeTaskSetIterative<FactorGraphType, TaskSetNormal,
-                                                 Schedul_Analysis>(
-                            tasks, coeff, maskForElimination,
-                            TaskSetNormal(tasks));
-                // NOTE: currently, only use this method for control_LL
-                // experiment
-                else if (optimizerType == 6) {
-                    TaskSetNormal tasksN(tasks);
-                    res = OptimizeControlIfopt<TaskSetNormal, RTA_LL>(tasksN,
-                                                                      coeff);
-                }
-                auto stop = std::chrono::high_resolution_clock::now();
-                size_t rtaCall = ReadRTAControl();
-                rtaCallTime.push_back(rtaCall / double(N));
-                auto duration =
-                    std::chrono::duration_cast<std::chrono::microseconds>(
-                        stop - start);
-                double timeTaken = double(duration.count()) / 1e6;
-                runTimeAll[0].push_back(timeTaken);
-                objVecAll[0].push_back(res.second);
-                if (objVecAll[0].size() == 633)
-                    int a = 1;
+                const BatchJobResult &jobRes = jobResults[jobIndex++];
+                N = jobRes.taskNumber;
+                rtaCallTime.push_back(jobRes.rtaCall / double(N));
+                runTimeAll[0].push_back(jobRes.timeTaken);
+                objVecAll[0].push_back(jobRes.res);
 
-                // check schedulability
-                UpdateTaskSetPeriod(tasks, res.first);
-                RTA_LL r(tasks);
-                if (!r.CheckSchedulability()) {
+                if (!jobRes.schedulable) {
                     failedFiles.push_back(file);
                 }
+                if (jobRes.timeOut) {
+                    failedFiles.push_back(file + " (time out)");
+                }
                 break;
             }
             case 1:  // read MILP result
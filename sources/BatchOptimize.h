@@ -1,5 +1,8 @@
 #pragma once
+#include <mutex>
+
 #include "sources/BatchOptimizeIO.h"
+#include "sources/BatchRunner.h"
 #include "sources/BatchTestutils.h"
 #include "sources/EnergyOptimization/EnergyIftopSpec.h"
 #include "sources/EnergyOptimization/EnergyOptimize.h"
@@ -26,88 +29,114 @@ void BatchOptimize(int Nn = -1) {
     std::vector<double> energySaveRatioVec;
     std::vector<double> runTime;
     std::vector<size_t> rtaCallTime;
-    int N;
     if (debugMode == 1)
         printf("Directory: %s\n", pathDataset);
     std::vector<std::string> errorFiles;
+    std::vector<std::string> files;
+    std::vector<double> jobCost;
     for (const auto &file : ReadFilesInDirectory(pathDataset)) {
         // if (debugMode)
         std::string delimiter = "-";
         if (file.substr(0, file.find(delimiter)) == "periodic" &&
             file.substr(file.length() - 4, 4) != ".txt") {
-            std::cout << file << std::endl;
-            double res;
-            double timeTaken;
-            if (VerifyResFileExist(pathDataset, file))  // already optimized
-            {
-                auto p = ReadFromResultFile(pathDataset, file);
-                res = p.first;
-                timeTaken = p.second;
-            } else {
-                std::string path = pathDataset + file;
-                TaskSetType tasksN;
-                if (TaskSetType::Type() == "normal") {
-                    auto tasks = ReadTaskSet(path, readTaskMode);
-                    tasksN.UpdateTaskSet(tasks);
-                    N = tasks.size();
-                    Nn = tasks.size();
-                }
-                // else if (TaskSetType::Type() == "dag")
-                // {
-                //     tasksN = ReadDAG_Tasks(path, readTaskMode);
-                //     N = tasksN.tasks_.size();
-                // }
-                else if (TaskSetType::Type() == "Nasri19") {
-                    tasksN = ReadDAGNasri19_Tasks(path);
-                    N = Nn;
-                    if (batchOptimizeFolder == "DAGPerformanceUtil") {
-                        N = round(Utilization(tasksN.tasks_) * 10.0 /
-                                  core_m_dag);
-                        std::cout << N << std::endl;
-                    }
-                } else {
-                    CoutError("Unrecognized TaskSetType!");
-                }
-
-                auto start = std::chrono::high_resolution_clock::now();
-                ResetCallingTimes();
-                if (optimizerType <= 4) {
-                    if (TaskSetType::Type() == "normal")
-                        res = Energy_Opt<TaskSetType, Schedul_Analysis>::
-                            OptimizeTaskSet(tasksN);
-                    else if (TaskSetType::Type() == "Nasri19")
-                        res = Energy_OptDAG<TaskSetType, Schedul_Analysis>::
-                                  OptimizeTaskSetIterative(tasksN)
-                                      .second;
-                } else if (optimizerType == 5)  // simulateed annealing
-                {
-                    auto resStruct =
-                        OptimizeSchedulingSA<TaskSetType, Schedul_Analysis>(
-                            tasksN);
-                    res = resStruct.optimizeError / resStruct.initialError;
-                } else if (optimizerType == 6)  // IPM-Ifopt
-                {
-                    res = OptimizeEnergyIfopt<TaskSetType, Schedul_Analysis>(
-                        tasksN);
-                }
-                auto stop = std::chrono::high_resolution_clock::now();
-                auto duration =
-                    std::chrono::duration_cast<std::chrono::microseconds>(
-                        stop - start);
-                timeTaken = double(duration.count()) / 1e6;
-
-                size_t rtaCall = ReadCallingTimes();
-                rtaCallTime.push_back(rtaCall);
+            files.push_back(file);
+            jobCost.push_back(EstimateJobCost(pathDataset + file));
+        }
+    }
 
-                WriteToResultFile(pathDataset, file, res, timeTaken);
+    // the jobs run on several threads, their progress lines must not mix
+    std::mutex coutMutex;
+    auto optimizeFile = [&](size_t fileIndex) {
+        const std::string &file = files[fileIndex];
+        {
+            std::lock_guard<std::mutex> lock(coutMutex);
+            std::cout << file << std::endl;
+        }
+        BatchJobResult jobRes;
+        if (VerifyResFileExist(pathDataset, file))  // already optimized
+        {
+            std::tie(jobRes.res, jobRes.timeTaken) =
+                ReadFromResultFile(pathDataset, file);
+            return jobRes;
+        }
+        // every task set is optimized with a fresh context
+        OptimizationContext context;
+        OptimizationContextScope scope(context);
+        context.SetTimeLimit(batchJobTimeLimit);
+        std::string path = pathDataset + file;
+        TaskSetType tasksN;
+        if (TaskSetType::Type() == "normal") {
+            auto tasks = ReadTaskSet(path, readTaskMode);
+            tasksN.UpdateTaskSet(tasks);
+            jobRes.taskNumber = tasks.size();
+        }
+        // else if (TaskSetType::Type() == "dag")
+        // {
+        //     tasksN = ReadDAG_Tasks(path, readTaskMode);
+        //     N = tasksN.tasks_.size();
+        // }
+        else if (TaskSetType::Type() == "Nasri19") {
+            tasksN = ReadDAGNasri19_Tasks(path);
+            if (batchOptimizeFolder == "DAGPerformanceUtil") {
+                std::lock_guard<std::mutex> lock(coutMutex);
+                std::cout << round(Utilization(tasksN.tasks_) * 10.0 /
+                                   core_m_dag)
+                          << std::endl;
             }
+        } else {
+            CoutError("Unrecognized TaskSetType!");
+        }
 
-            if (res >= 0 && res <= 1) {
-                energySaveRatioVec.push_back(res);
-                runTime.push_back(timeTaken);
-            } else {
-                errorFiles.push_back(file);
-            }
+        auto start = std::chrono::high_resolution_clock::now();
+        double res;
+        if (optimizerType <= 4) {
+            if (TaskSetType::Type() == "normal")
+                res = Energy_Opt<TaskSetType, Schedul_Analysis>::
+                    OptimizeTaskSet(tasksN, context);
+            else if (TaskSetType::Type() == "Nasri19")
+                res = Energy_OptDAG<TaskSetType, Schedul_Analysis>::
+                          OptimizeTaskSetIterative(tasksN, context)
+                              .second;
+        } else if (optimizerType == 5)  // simulateed annealing
+        {
+            auto resStruct =
+                OptimizeSchedulingSA<TaskSetType, Schedul_Analysis>(tasksN);
+            res = resStruct.optimizeError / resStruct.initialError;
+        } else if (optimizerType == 6)  // IPM-Ifopt
+        {
+            res = OptimizeEnergyIfopt<TaskSetType, Schedul_Analysis>(tasksN);
+        }
+        auto stop = std::chrono::high_resolution_clock::now();
+        auto duration =
+            std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
+        jobRes.res = res;
+        jobRes.timeTaken = double(duration.count()) / 1e6;
+        jobRes.rtaCall = context.rtaCallingTimes;
+        jobRes.optimized = true;
+        jobRes.timeOut = context.TimeOut();
+        // time-out results are not final, they are optimized again on resume
+        if (!jobRes.timeOut)
+            WriteToResultFile(pathDataset, file, jobRes.res, jobRes.timeTaken);
+        return jobRes;
+    };
+    std::vector<BatchJobResult> jobResults = RunBatchParallel<BatchJobResult>(
+        jobCost, optimizeFile, BatchThreadNumber(TaskSetType::Type()));
+
+    // aggregate in the directory order
+    for (size_t i = 0; i < files.size(); i++) {
+        const BatchJobResult &jobRes = jobResults[i];
+        if (jobRes.optimized) {
+            rtaCallTime.push_back(jobRes.rtaCall);
+            if (TaskSetType::Type() == "normal")
+                Nn = jobRes.taskNumber;
+        }
+        if (jobRes.timeOut) {
+            errorFiles.push_back(files[i] + " (time out)");
+        } else if (jobRes.res >= 0 && jobRes.res <= 1) {
+            energySaveRatioVec.push_back(jobRes.res);
+            runTime.push_back(jobRes.timeTaken);
+        } else {
+            errorFiles.push_back(files[i]);
         }
     }
 
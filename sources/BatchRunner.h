@@ -0,0 +1,115 @@
+/**
+ * @file BatchRunner.h
+ * @brief Runs the independent jobs of a batch experiment (one task set file
+ * each) concurrently.
+ *
+ * Jobs are handed out one at a time from a shared queue sorted by estimated
+ * cost, largest first, so that the long jobs do not end up on the tail of the
+ * schedule. The workers live in a TBB arena; once the queue is empty, idle
+ * threads steal the nested parallel work (numerical Jacobians, Nasri19's
+ * analysis) of the jobs that are still running.
+ *
+ * Results are returned in the order of the job indices, so aggregating them
+ * sequentially gives the same output whatever the number of threads.
+ */
+#pragma once
+
+#include <sys/stat.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#include <tbb/task_arena.h>
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sources/Utils/Parameters.h"
+
+namespace rt_num_opt {
+
+struct BatchJobResult {
+    double res;
+    double timeTaken;
+    size_t rtaCall;
+    int taskNumber;
+    // false if the result is read from the result file of a previous run
+    bool optimized;
+    bool timeOut;
+    // whether the optimized result passes the final schedulability check
+    bool schedulable;
+    BatchJobResult()
+        : res(-1),
+          timeTaken(0),
+          rtaCall(0),
+          taskNumber(0),
+          optimized(false),
+          timeOut(false),
+          schedulable(true) {}
+};
+
+// larger task set files contain more tasks, and take longer to optimize
+inline double EstimateJobCost(const std::string &path) {
+    struct stat fileStat;
+    if (stat(path.c_str(), &fileStat) != 0)
+        return 0;
+    return fileStat.st_size;
+}
+
+/**
+ * @brief number of jobs to run concurrently; debugMode = 1 runs serially
+ * because its prints and files, e.g., outputTask.csv, are shared
+ *
+ * @param taskSetType TaskSetType::Type() of the jobs; Nasri19 task sets also
+ * run one at a time: their analysis is parallel already, and its time-out
+ * reads the CPU time of the whole process, which concurrent jobs would use up
+ * @param debug the debugMode to decide for
+ */
+inline int BatchThreadNumber(const std::string &taskSetType = "",
+                             int debug = debugMode) {
+    if (debug == 1 || taskSetType == "Nasri19")
+        return 1;
+    if (batchThreadNumber > 0)
+        return batchThreadNumber;
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/**
+ * @brief run job(i) for every i in [0, cost.size()), larger cost first
+ *
+ * @param cost estimated cost of each job, e.g., EstimateJobCost
+ * @param job Result(size_t index), must only touch its own data
+ * @return std::vector<Result> the i-th element is job(i)
+ */
+template <typename Result, typename Job>
+std::vector<Result> RunBatchParallel(const std::vector<double> &cost,
+                                     const Job &job,
+                                     int threadNum = BatchThreadNumber()) {
+    size_t n = cost.size();
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&cost](size_t a, size_t b) {
+        return cost[a] > cost[b];
+    });
+
+    std::vector<Result> results(n);
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t k = next++; k < n; k = next++)
+            results[order[k]] = job(order[k]);
+    };
+    if (threadNum <= 1 || n <= 1) {
+        worker();
+        return results;
+    }
+    tbb::task_arena arena(threadNum);
+    arena.execute([&]() {
+        tbb::parallel_for(
+            0, threadNum, [&](int) { worker(); }, tbb::simple_partitioner());
+    });
+    return results;
+}
+
+}  // namespace rt_num_opt
@@ -1,6 +1,7 @@
 #pragma once
 #include "sources/BatchControlOptimize.h"
 #include "sources/BatchOptimizeIO.h"
+#include "sources/BatchRunner.h"
 #include "sources/BatchTestutils.h"
 #include "sources/ControlOptimization/ControlIfoptSpec.h"
 #include "sources/ControlOptimization/ControlOptimize.h"
@@ -99,57 +100,68 @@ double BatchOptimizeNasri19(int Nn = 5) {
         printf("Directory: %s\n", pathDataset);
     std::vector<std::string> errorFiles;
     std::string worstFile = "";
+    std::vector<std::string> files;
+    std::vector<double> jobCost;
     for (const auto &file : ReadFilesInDirectory(pathDataset)) {
-        int type = ControlNasri19::TargetFileType(file);
-        std::string path = pathDataset + file;
-        switch (type) {
-            case 0:  // perform optimization
-            {
-                std::cout << file << std::endl;
-                DAG_Nasri19 dag_tasks = ReadDAGNasri19_Tasks(path);
-                VectorDynamic coeff = ReadControlCoeff(path);
-                std::vector<bool> maskForElimination(dag_tasks.SizeDag(),
-                                                     false);
-                double obj_res;
-                double timeTaken;
-                if (ControlNasri19::VerifyResFileExist(pathDataset, file)) {
-                    std::pair<double, double> res_from_read =
-                        ControlNasri19::ReadFromResultFile(pathDataset, file);
-                    timeTaken = res_from_read.second;
-                    obj_res = res_from_read.first;
-                } else {
-                    auto start = std::chrono::high_resolution_clock::now();
-                    std::pair<VectorDynamic, double> res =
-                        OptimizeTaskSetIterative<
-                            FactorGraphNasri<DAG_Nasri19, RTA_Nasri19>,
-                            DAG_Nasri19, RTA_Nasri19>(dag_tasks, coeff,
-                                                      maskForElimination);
-                    auto stop = std::chrono::high_resolution_clock::now();
-                    auto duration =
-                        std::chrono::duration_cast<std::chrono::microseconds>(
-                            stop - start);
-                    timeTaken = double(duration.count()) / 1e6;
-                    obj_res = res.second;
-                }
+        if (ControlNasri19::TargetFileType(file) == 0) {
+            files.push_back(file);
+            jobCost.push_back(EstimateJobCost(pathDataset + file));
+        }
+    }
 
-                runTime.push_back(timeTaken);
-                objVec.push_back(obj_res);
-                if (obj_res > 1)
-                    failedFiles.push_back(file);
-                std::string pathRes =
-                    "/home/zephyr/Programming/Energy_Opt_NLP/"
-                    "CompareWithBaseline/" +
-                    batchOptimizeFolder + "/EnergySaveRatio/N" +
-                    std::to_string(Nn) + ".txt";
-                AddEntry(pathRes, obj_res);
-                ControlNasri19::WriteToResultFile(pathDataset, file, obj_res,
-                                                  timeTaken);
-                break;
-            }
-            default: {
-                continue;
-            }
+    auto optimizeFile = [&](size_t fileIndex) {
+        const std::string &file = files[fileIndex];
+        std::string path = pathDataset + file;
+        std::cout << file << std::endl;
+        BatchJobResult jobRes;
+        if (ControlNasri19::VerifyResFileExist(pathDataset, file)) {
+            std::tie(jobRes.res, jobRes.timeTaken) =
+                ControlNasri19::ReadFromResultFile(pathDataset, file);
+            return jobRes;
         }
+        // every task set is optimized with a fresh context
+        OptimizationContext context;
+        OptimizationContextScope scope(context);
+        context.SetTimeLimit(batchJobTimeLimit);
+        DAG_Nasri19 dag_tasks = ReadDAGNasri19_Tasks(path);
+        VectorDynamic coeff = ReadControlCoeff(path);
+        std::vector<bool> maskForElimination(dag_tasks.SizeDag(), false);
+        auto start = std::chrono::high_resolution_clock::now();
+        std::pair<VectorDynamic, double> res =
+            OptimizeTaskSetIterative<FactorGraphNasri<DAG_Nasri19, RTA_Nasri19>,
+                                     DAG_Nasri19, RTA_Nasri19>(
+                dag_tasks, coeff, maskForElimination, context);
+        auto stop = std::chrono::high_resolution_clock::now();
+        auto duration =
+            std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
+        jobRes.res = res.second;
+        jobRes.timeTaken = double(duration.count()) / 1e6;
+        jobRes.optimized = true;
+        jobRes.timeOut = context.TimeOut();
+        // time-out results are not final, they are optimized again on resume
+        if (!jobRes.timeOut)
+            ControlNasri19::WriteToResultFile(pathDataset, file, jobRes.res,
+                                              jobRes.timeTaken);
+        return jobRes;
+    };
+    std::vector<BatchJobResult> jobResults = RunBatchParallel<BatchJobResult>(
+        jobCost, optimizeFile, BatchThreadNumber(DAG_Nasri19::Type()));
+
+    // aggregate in the directory order
+    std::string pathResEntry =
+        "/home/zephyr/Programming/Energy_Opt_NLP/"
+        "CompareWithBaseline/" +
+        batchOptimizeFolder + "/EnergySaveRatio/N" + std::to_string(Nn) +
+        ".txt";
+    for (size_t i = 0; i < files.size(); i++) {
+        const BatchJobResult &jobRes = jobResults[i];
+        runTime.push_back(jobRes.timeTaken);
+        objVec.push_back(jobRes.res);
+        if (jobRes.res > 1)
+            failedFiles.push_back(files[i]);
+        if (jobRes.timeOut)
+            failedFiles.push_back(files[i] + " (time out)");
+        AddEntry(pathResEntry, jobRes.res);
     }
     std::string pathRes =
         "/home/zephyr/Programming/Energy_Opt_NLP/CompareWithBaseline/" +
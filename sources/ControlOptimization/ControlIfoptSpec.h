@@ -25,7 +25,7 @@ class ExVariablesControl : public ifopt::VariableSet {
         : VariableSet(tasks.size(), name) {
         // the initial values where the NLP starts iterating from
         tasks_ = tasks;
-        upperBound_ = GetParameterVD<double>(tasks_, "period");
+        upperBound_ = GetParameterVD<double, &Task::period>(tasks_);
         if (debugMode == 1)
             std::cout << "UB: " << upperBound_ << std::endl;
         var_ = upperBound_;
@@ -150,7 +150,7 @@ VectorDynamic ClampControlResultBasedOnFeasibility(TaskSetType &tasks,
     UpdateTaskSetPeriod(tasks, x);
     Schedul_Analysis r(tasks);
     if (!r.CheckSchedulability()) {
-        return GetParameterVD<double>(tasks, "periodOrg");
+        return GetParameterVD<double, &Task::periodOrg>(tasks);
     } else
         return x;
 }
@@ -14,6 +14,7 @@
 #include "sources/Utils/InequalifyFactor.h"
 // #include "Optimize.h"
 #include "sources/ControlOptimization/ReadControlCases.h"
+#include "sources/RTA/RTA_LL_Incremental.h"
 #include "sources/Utils/MultiKeyFactor.h"
 #include "sources/Utils/Parameters.h"
 namespace rt_num_opt {
@@ -23,6 +24,8 @@ std::pair<VectorDynamic, double> UnitOptimizationPeriod(
     TaskSet &tasks, VectorDynamic &coeff, std::vector<bool> &maskForElimination,
     const TaskSetType &taskSetType) {
     BeginTimer(__func__);
+    double relativeErrorTolerance =
+        CurrentOptimizationContext().relativeErrorTolerance;
     gtsam::NonlinearFactorGraph graph = FactorGraphType::BuildControlGraph(
         maskForElimination, tasks, coeff, taskSetType);
     gtsam::Values initialEstimateFG =
@@ -166,7 +169,9 @@ void RoundPeriod(TaskSet &tasks, std::vector<bool> &maskForElimination,
                 wait_for_eliminate_index.push_back(i);
         }
         if (!wait_for_eliminate_index.empty()) {
-            VectorDynamic rtaBase = RTAVector(tasks);
+            // each probe only re-analyzes the probed task and the lower
+            // priority tasks
+            RTA_LL_Incremental r(tasks);
 
             std::vector<std::pair<int, double>> objectiveVec;
             objectiveVec.reserve(wait_for_eliminate_index.size());
@@ -196,9 +201,8 @@ void RoundPeriod(TaskSet &tasks, std::vector<bool> &maskForElimination,
                     int mid = (left + right) / 2;
 
                     tasks[currentIndex].period = mid;
-                    RTA_LL r(tasks);
-                    schedulale_flag =
-                        r.CheckSchedulability(rtaBase, debugMode == 1);
+                    r.UpdatePeriod(currentIndex, mid);
+                    schedulale_flag = r.CheckSchedulability(debugMode == 1);
                     if (not schedulale_flag) {
                         left = mid + 1;
                         tasks[currentIndex].period = rightOrg;
@@ -209,6 +213,7 @@ void RoundPeriod(TaskSet &tasks, std::vector<bool> &maskForElimination,
                 }
 
                 tasks[currentIndex].period = left;
+                r.UpdatePeriod(currentIndex, left);
                 objectiveVec.erase(objectiveVec.begin() + 0);
 
                 iterationNumber++;
@@ -235,10 +240,13 @@ bool ContainFalse(std::vector<bool> &eliminationRecord) {
     return false;
 }
 
+// context becomes the current OptimizationContext during the optimization
 template <typename FactorGraphType, class TaskSetType, class Schedul_Analysis>
 static std::pair<VectorDynamic, double> OptimizeTaskSetIterative(
     TaskSet &tasks, VectorDynamic &coeff, std::vector<bool> &maskForElimination,
-    const TaskSetType &taskSetType) {
+    const TaskSetType &taskSetType,
+    OptimizationContext &context = CurrentOptimizationContext()) {
+    OptimizationContextScope scope(context);
     VectorDynamic periodResCurr, periodResPrev;
     std::vector<bool> maskForEliminationPrev = maskForElimination;
     double errPrev = 1e30;
@@ -258,10 +266,11 @@ static std::pair<VectorDynamic, double> OptimizeTaskSetIterative(
     }
     // double disturbIte = eliminateTol;
     while (errCurr < errPrev * (1 - relativeErrorToleranceOuterLoop) &&
-           ContainFalse(maskForElimination) && loopCount < MaxLoopControl) {
+           ContainFalse(maskForElimination) && loopCount < MaxLoopControl &&
+           !context.TimeOut()) {
         // store prev result
         errPrev = errCurr;
-        periodResPrev = GetParameterVD<double>(tasks, "period");
+        periodResPrev = GetParameterVD<double, &Task::period>(tasks);
         maskForEliminationPrev = maskForElimination;
 
         // perform optimization
@@ -296,8 +305,8 @@ static std::pair<VectorDynamic, double> OptimizeTaskSetIterative(
         RoundPeriod(tasks, maskForElimination, coeff);
         errCurr = FactorGraphType::RealObj(tasks, coeff, taskSetType);
         if (Equals(maskForElimination, maskForEliminationPrev) &&
-            relativeErrorTolerance > relativeErrorToleranceMin) {
-            relativeErrorTolerance = relativeErrorTolerance / 10;
+            context.relativeErrorTolerance > relativeErrorToleranceMin) {
+            context.relativeErrorTolerance /= 10;
         }
         if (debugMode) {
             using namespace std;
@@ -319,10 +328,11 @@ static std::pair<VectorDynamic, double> OptimizeTaskSetIterative(
     RTA_LL r(tasks);
     if (r.CheckSchedulability()) {
         return std::make_pair(
-            GetParameterVD<double>(tasks, "period"),
+            GetParameterVD<double, &Task::period>(tasks),
             FactorGraphType::RealObj(tasks, coeff, taskSetType));
     } else {
-        VectorDynamic periodVecOrg = GetParameterVD<double>(tasks, "periodOrg");
+        VectorDynamic periodVecOrg =
+            GetParameterVD<double, &Task::periodOrg>(tasks);
         UpdateTaskSetPeriod(tasks, periodVecOrg);
         return std::make_pair(
             periodVecOrg, FactorGraphType::RealObj(tasks, coeff, taskSetType));
@@ -25,6 +25,8 @@ std::pair<VectorDynamic, double> UnitOptimizationPeriod(
     const TaskSetType &taskSetType, VectorDynamic &coeff,
     std::vector<bool> &maskForElimination) {
     BeginTimer(__func__);
+    double relativeErrorTolerance =
+        CurrentOptimizationContext().relativeErrorTolerance;
     gtsam::NonlinearFactorGraph graph = FactorGraphType::BuildControlGraph(
         taskSetType, maskForElimination, coeff);
     gtsam::Values initialEstimateFG =
@@ -207,11 +209,14 @@ void InitializePriorityAssignment(TaskSetType &taskSetType,
 }
 
 // only accepts DAG-related task set type, update taskSetType during
+// optimization; context becomes the current OptimizationContext during the
 // optimization
 template <typename FactorGraphType, class TaskSetType, class Schedul_Analysis>
 static std::pair<VectorDynamic, double> OptimizeTaskSetIterative(
     TaskSetType &taskSetType, VectorDynamic &coeff,
-    std::vector<bool> &maskForElimination) {
+    std::vector<bool> &maskForElimination,
+    OptimizationContext &context = CurrentOptimizationContext()) {
+    OptimizationContextScope scope(context);
     auto run_time_track_start = std::chrono::high_resolution_clock::now();
 
     double err_initial = FactorGraphType::RealObj(taskSetType, coeff);
@@ -227,7 +232,8 @@ static std::pair<VectorDynamic, double> OptimizeTaskSetIterative(
     double pa_change_threshold = Priority_assignment_adjustment_threshold;
     PriorityAssignmentRecord pa_record;
 
-    while (loopCount < MaxLoopControl && !(ifTimeout(run_time_track_start))) {
+    while (loopCount < MaxLoopControl && !(ifTimeout(run_time_track_start)) &&
+           !context.TimeOut()) {
         maskForEliminationPrev = maskForElimination;
 
         // perform optimization
@@ -271,8 +277,8 @@ static std::pair<VectorDynamic, double> OptimizeTaskSetIterative(
                                                      maskForElimination);
 
         if (Equals(maskForElimination, maskForEliminationPrev) &&
-            relativeErrorTolerance > relativeErrorToleranceMin) {
-            relativeErrorTolerance = relativeErrorTolerance / 10;
+            context.relativeErrorTolerance > relativeErrorToleranceMin) {
+            context.relativeErrorTolerance /= 10;
         }
 
         loopCount++;
@@ -294,7 +300,7 @@ static std::pair<VectorDynamic, double> OptimizeTaskSetIterative(
     RTA_Nasri19 r(taskSetType);
     if (r.CheckSchedulabilityLongTimeOut()) {
         return std::make_pair(
-            GetParameterVD<double>(taskSetType.tasks_, "period"),
+            GetParameterVD<double, &Task::period>(taskSetType.tasks_),
             FactorGraphType::RealObj(taskSetType, coeff) / err_initial);
     } else {
         CoutWarning("Return unschedulable result during control optimization!");
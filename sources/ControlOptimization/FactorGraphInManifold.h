@@ -24,7 +24,7 @@ struct FactorGraphInManifold {
     // TODO: pass by reference
     static VectorDynamic ExtractResults(const gtsam::Values &result,
                                         const TaskSet &tasks) {
-        VectorDynamic periods = GetParameterVD<double>(tasks, "period");
+        VectorDynamic periods = GetParameterVD<double, &Task::period>(tasks);
         for (uint i = 0; i < tasks.size(); i++) {
             if (result.exists(GenerateKey(i, "period"))) {
                 periods(i, 0) =
@@ -143,18 +143,11 @@ struct FactorGraphInManifold {
             BeginTimer("RTARelatedFactor_unwhitenedError");
             gtsam::Vector result = f_with_RTA(x);
             if (H) {
+                if (exactJacobian)
+                    *H = NumericalDerivativeMultiKey(
+                        f_with_RTA, x, keyVec, deltaOptimizer, result.rows());
                 for (int i = 0; i < dimension; i++) {
-                    if (exactJacobian) {
-                        NormalErrorFunction1D f =
-                            [x, i, this](const VectorDynamic xi) {
-                                gtsam::Symbol a = keyVec.at(i);
-                                gtsam::Values xx = x;
-                                xx.update(a, xi);
-                                return f_with_RTA(xx);
-                            };
-                        (*H)[i] = NumericalDerivativeDynamic(
-                            f, x.at<VectorDynamic>(keyVec[i]), deltaOptimizer);
-                    } else {
+                    if (!exactJacobian) {
                         VectorDynamic jacob = GenerateVectorDynamic(2);
                         int taskId = AnalyzeKey(keyVec[i]);
                         if (taskId == index) {
@@ -222,7 +215,7 @@ struct FactorGraphInManifold {
         BeginTimer(__func__);
         gtsam::NonlinearFactorGraph graph;
         double periodMax =
-            GetParameterVD<double>(tasks, "executionTime").sum() * 5;
+            GetParameterVD<double, &Task::executionTime>(tasks).sum() * 5;
         auto modelNormal =
             gtsam::noiseModel::Isotropic::Sigma(1, noiseModelSigma);
         auto modelPunishmentSoft1 = gtsam::noiseModel::Isotropic::Sigma(
@@ -32,7 +32,7 @@ struct FactorGraphNasri {
     static VectorDynamic ExtractNodePeriodVec(
         const gtsam::Values &result, const TaskSetType &taskSetTypeRef) {
         VectorDynamic periods =
-            GetParameterVD<double>(taskSetTypeRef, "period");
+            GetParameterVD<double, &Task::period>(taskSetTypeRef);
         size_t node_overall_count = 0;
         for (size_t taskId = 0; taskId < taskSetTypeRef.tasksVecNasri_.size();
              taskId++) {
@@ -223,19 +223,14 @@ struct FactorGraphNasri {
             }
             if (H) {
                 if (exactJacobian) {
-                    for (uint i = 0; i < keyVec.size(); i++) {
-                        NormalErrorFunction1D f =
-                            [x, i, this](const VectorDynamic xi) {
-                                gtsam::Symbol a = keyVec.at(i);
-                                gtsam::Values xx = x;
-                                xx.update(a, xi);
-                                return f_with_RTA(xx);
-                            };
-                        (*H)[i] = NumericalDerivativeDynamic(
-                            f, x.at<VectorDynamic>(keyVec[i]), deltaOptimizer);
-                        if (debugMode == 1) {
+                    *H = NumericalDerivativeMultiKeyBatch(
+                        GenerateBatchEvaluator(
+                            f_with_RTA,
+                            ParallelJacobian(Schedul_Analysis::type())),
+                        x, keyVec, deltaOptimizer, result.rows());
+                    if (debugMode == 1) {
+                        for (uint i = 0; i < keyVec.size(); i++)
                             std::cout << (*H)[i] << "\n\n";
-                        }
                     }
                 } else {
                     TaskSetType taskSetTypeRounded = taskSetType;
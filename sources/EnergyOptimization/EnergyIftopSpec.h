@@ -28,7 +28,7 @@ namespace rt_num_opt
         {
             // the initial values where the NLP starts iterating from
             tasks_ = tasks;
-            lowerBound_ = GetParameterVD<double>(tasks_, "executionTimeOrg");
+            lowerBound_ = GetParameterVD<double, &Task::executionTimeOrg>(tasks_);
             var_ = lowerBound_;
         }
 
@@ -179,7 +179,7 @@ namespace rt_num_opt
         Schedul_Analysis r(tasks);
         if (!r.CheckSchedulability())
         {
-            return GetParameterVD<double>(tasks, "executionTimeOrg");
+            return GetParameterVD<double, &Task::executionTimeOrg>(tasks);
         }
         else
             return x;
@@ -198,7 +198,7 @@ namespace rt_num_opt
             return energyAfterOpt / weightEnergy;
         else if (runMode == "normal")
         {
-            UpdateTaskSetExecutionTime(tasksN, GetParameterVD<double>(tasksN, "executionTimeOrg"));
+            UpdateTaskSetExecutionTime(tasksN, GetParameterVD<double, &Task::executionTimeOrg>(tasksN));
             double initialEnergyCost = EstimateEnergyTaskSet(tasksN.tasks_).sum();
             return energyAfterOpt / initialEnergyCost;
         }
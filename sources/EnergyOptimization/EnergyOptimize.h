@@ -82,6 +82,8 @@ class Energy_OptDAG {
     static std::pair<VectorDynamic, double> UnitOptimization(
         TaskSetType &tasks, EliminationRecord &eliminationRecord) {
         BeginTimer(__func__);
+        double relativeErrorTolerance =
+            CurrentOptimizationContext().relativeErrorTolerance;
         gtsam::NonlinearFactorGraph graph =
             BuildEnergyGraph(tasks, eliminationRecord);
         gtsam::Values initialEstimateFG =
@@ -204,8 +206,15 @@ class Energy_OptDAG {
         return std::make_pair(whetherEliminate, eliminationRecord);
     }
 
+    /**
+     * @brief context becomes the current OptimizationContext during the
+     * optimization
+     */
     static std::pair<VectorDynamic, double> OptimizeTaskSetIterative(
-        TaskSetType &tasks) {
+        TaskSetType &tasks,
+        OptimizationContext &context = CurrentOptimizationContext()) {
+        OptimizationContextScope scope(context);
+        context.InitializeGlobalVector(tasks.size());
         EliminationRecord eliminationRecord;
         eliminationRecord.Initialize(tasks.size());
 
@@ -220,7 +229,7 @@ class Energy_OptDAG {
             // store prev result
             errPrev = errCurr;
             executionTimeResPrev =
-                GetParameterVD<double>(tasks, "executionTime");
+                GetParameterVD<double, &Task::executionTime>(tasks);
 
             std::tie(executionTimeResCurr, errCurr) =
                 UnitOptimization(tasks, eliminationRecord);
@@ -229,7 +238,8 @@ class Energy_OptDAG {
                 FindEliminateVariable(tasks, eliminationRecord);
 
             loopCount++;
-            if (loopCount > elimIte || eliminationRecord.whetherAllEliminated())
+            if (loopCount > elimIte ||
+                eliminationRecord.whetherAllEliminated() || context.TimeOut())
                 break;
         }
 
@@ -239,8 +249,8 @@ class Energy_OptDAG {
             << loopCount << std::endl;
         // std::cout << "Best optimal found: " << valueGlobalOpt << std::endl;
         std::cout << "After optimiazation found: " << postError << std::endl;
-        if (valueGlobalOpt < postError) {
-            UpdateTaskSetExecutionTime(tasks.tasks_, vectorGlobalOpt);
+        if (context.valueGlobalOpt < postError) {
+            UpdateTaskSetExecutionTime(tasks.tasks_, context.vectorGlobalOpt);
         }
 
         // verify feasibility
@@ -263,7 +273,7 @@ class Energy_OptDAG {
             }
         }
         return std::make_pair(
-            GetParameterVD<double>(tasks, "executionTime"),
+            GetParameterVD<double, &Task::executionTime>(tasks),
             EnergyOptUtils::RealObj(tasks.tasks_) / initialError);
     }
 };
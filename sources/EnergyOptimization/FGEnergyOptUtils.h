@@ -24,7 +24,7 @@ static gtsam::Values GenerateInitialFG(TaskSetNormal tasks,
 VectorDynamic ExtractResults(const gtsam::Values &result,
                              const TaskSet &tasks) {
     VectorDynamic executionTimes =
-        GetParameterVD<double>(tasks, "executionTime");
+        GetParameterVD<double, &Task::executionTime>(tasks);
     for (uint i = 0; i < tasks.size(); i++) {
         if (result.exists(GenerateKey(i, "executionTime"))) {
             executionTimes(i, 0) =
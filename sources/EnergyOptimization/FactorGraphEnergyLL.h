@@ -32,7 +32,7 @@ struct FactorGraphEnergyLL {
         BeginTimer(__func__);
         whether_new_eliminate = false;
         if (debugMode == 1) {
-            std::cout << GetParameterVD<double>(tasks, "executionTime")
+            std::cout << GetParameterVD<double, &Task::executionTime>(tasks)
                       << std::endl;
         }
 
@@ -7,6 +7,7 @@ double GetFrequency(const Task &task) {
     if (executionTimeModel == 1) {
         return task.executionTimeOrg / task.executionTime;
     } else if (executionTimeModel == 2) {
+        double frequencyRatio = CurrentOptimizationContext().frequencyRatio;
         return task.executionTimeOrg * frequencyRatio /
                (task.executionTime -
                 task.executionTimeOrg * (1 - frequencyRatio));
@@ -28,10 +28,12 @@
 #include "sources/EnergyOptimization/FrequencyModel.h"
 #include "sources/MatrixConvenient.h"
 #include "sources/RTA/RTA_LL.h"
+#include "sources/RTA/RTA_LL_Incremental.h"
 #include "sources/TaskModel/TaskSetNormal.h"
 #include "sources/TaskModel/Tasks.h"
 #include "sources/Utils/GlobalVariables.h"
 #include "sources/Utils/Parameters.h"
+#include "sources/Utils/SpeculativeSearch.h"
 #include "sources/Utils/utils.h"
 // #include "sources/EnergyOptimization/EnergyOptimize.h"
 namespace rt_num_opt {
@@ -70,6 +72,8 @@ class Energy_Opt {
         int lastTaskDoNotNeedOptimize;
         VectorDynamic responseTimeInitial;
         int N;
+        // receives the best solution found during evaluations
+        OptimizationContext *context_;
 
         ComputationFactor(gtsam::Key key, TaskSetType &tasks,
                           int lastTaskDoNotNeedOptimize,
@@ -78,7 +82,8 @@ class Energy_Opt {
             : gtsam::NoiseModelFactor1<VectorDynamic>(model, key),
               tasks_(tasks),
               lastTaskDoNotNeedOptimize(lastTaskDoNotNeedOptimize),
-              responseTimeInitial(responseTimeInitial) {
+              responseTimeInitial(responseTimeInitial),
+              context_(&CurrentOptimizationContext()) {
             N = tasks_.tasks_.size();
         }
 
@@ -95,12 +100,10 @@ class Energy_Opt {
                         taskDurOpt[i].executionTime)
                     return;
             }
-            if (currentEnergyConsumption / weightEnergy < valueGlobalOpt) {
-                // update globalOptVector
-                vectorGlobalOpt =
-                    GetParameterVD<double>(taskDurOpt, "executionTime");
-                valueGlobalOpt = currentEnergyConsumption / weightEnergy;
-            }
+            // update globalOptVector if the current one is better
+            context_->UpdateGlobalOpt(
+                currentEnergyConsumption / weightEnergy,
+                GetParameterVD<double, &Task::executionTime>(taskDurOpt));
         }
         /**
          * @brief
@@ -247,6 +250,14 @@ class Energy_Opt {
                 for (int i = 0; i < N; i++) tasks[i].print();
             }
 
+            // in RTA_LL, a WCET only influences its own and the lower
+            // priority tasks, so the probes copy an analyzed base and
+            // re-analyze from currentIndex
+            bool incremental = Schedul_Analysis::type() == "LL";
+            RTA_LL_Incremental rBase;
+            if (incremental)
+                rBase.Reset(tasks);
+
             // int left = 0, right = 0;
             while (objectiveVec.size() > 0) {
                 int currentIndex = objectiveVec[0].first;
@@ -265,22 +276,39 @@ class Energy_Opt {
                     CoutError("left > right error in clamp!");
                 }
                 int rightOrg = right;
-                bool schedulale_flag;
-                while (left < right) {
-                    int mid = ceil((left + right) / 2.0);
-
-                    tasks[currentIndex].executionTime = mid;
-                    Schedul_Analysis r(tasksSetType);
-                    schedulale_flag = r.CheckSchedulability(responseTimeInitial,
-                                                            debugMode == 1);
-                    if ((not schedulale_flag) || not WithInBound(tasks)) {
-                        right = mid - 1;
-                    } else {
-                        // comp(currentIndex, 0) = mid;
-                        tasks[currentIndex].executionTime = mid;
-                        left = mid;
-                    }
+                // the other tasks do not change during the search
+                TaskSet tasksOther = tasks;
+                tasksOther.erase(tasksOther.begin() + currentIndex);
+                bool otherWithInBound = WithInBound(tasksOther);
+                if (incremental) {
+                    rBase.UpdateTaskSet(tasks);
+                    // the higher priority tasks are analyzed once for all
+                    // the probes
+                    if (currentIndex > 0)
+                        rBase.RTA_Common_Warm(currentIndex - 1);
                 }
+                auto feasible = [&](int mid) {
+                    TaskSet taskProbe = {tasks[currentIndex]};
+                    taskProbe[0].executionTime = mid;
+                    if (!otherWithInBound || !WithInBound(taskProbe))
+                        return false;
+                    if (incremental) {
+                        RTA_LL_Incremental r = rBase;
+                        r.UpdateExecutionTime(currentIndex, mid);
+                        return r.CheckSchedulability(debugMode == 1);
+                    }
+                    TaskSetType tasksProbe = tasksSetType;
+                    tasksProbe.tasks_[currentIndex].executionTime = mid;
+                    Schedul_Analysis r(tasksProbe);
+                    return r.CheckSchedulability(responseTimeInitial,
+                                                 debugMode == 1);
+                };
+                // Nasri19's analysis is parallel itself, and concurrent
+                // probes would use up the CPU time its time-out measures
+                int depth = Schedul_Analysis::type() == "Nasri19"
+                                ? 1
+                                : SpeculationDepth();
+                left = SpeculativeBisection(left, right, feasible, depth);
 
                 // post processing, left=right is the value we want
                 tasks[currentIndex].executionTime = left;
@@ -338,6 +366,10 @@ class Energy_Opt {
         TaskSetType tasksCurr = tasks;
         int N = tasks.tasks_.size();
         double SkipRateFindElimination = 0;
+        // only task i and its lower priority tasks need re-analysis in RTA_LL
+        RTA_LL_Incremental rIncremental;
+        if (Schedul_Analysis::type() == "LL")
+            rIncremental.Reset(tasksCurr.tasks_);
         for (int i = N - 1; i > lastTaskDoNotNeedOptimize; i--) {
             if (((double)rand() / (RAND_MAX)) < SkipRateFindElimination) {
                 continue;
@@ -356,9 +388,16 @@ class Energy_Opt {
             //  because it may trigger early detection of termination
 
             double tolerance = 0.0;
-            Schedul_Analysis r(tasksCurr);
-            bool schedulable = r.CheckSchedulability(computationTimeWarmStart,
-                                                     false, tolerance);
+            bool schedulable;
+            if (Schedul_Analysis::type() == "LL") {
+                rIncremental.UpdateExecutionTime(
+                    i, tasksCurr.tasks_[i].executionTime);
+                schedulable = rIncremental.CheckSchedulability(false, tolerance);
+            } else {
+                Schedul_Analysis r(tasksCurr);
+                schedulable = r.CheckSchedulability(computationTimeWarmStart,
+                                                    false, tolerance);
+            }
 
             if (!schedulable) {
                 EndTimer(__func__);
@@ -366,6 +405,9 @@ class Energy_Opt {
             }
 
             tasksCurr.tasks_[i].executionTime -= eliminateTolIte;
+            if (Schedul_Analysis::type() == "LL")
+                rIncremental.UpdateExecutionTime(
+                    i, tasksCurr.tasks_[i].executionTime);
         }
         EndTimer(__func__);
         return lastTaskDoNotNeedOptimize;
@@ -377,6 +419,8 @@ class Energy_Opt {
                                           VectorDynamic &responseTimeInitial) {
         BeginTimer(__func__);
         int N = tasks.tasks_.size();
+        double relativeErrorTolerance =
+            CurrentOptimizationContext().relativeErrorTolerance;
 
         // build the factor graph
         auto model = gtsam::noiseModel::Isotropic::Sigma(N, noiseModelSigma);
@@ -451,6 +495,7 @@ class Energy_Opt {
      **/
     static double OptimizeTaskSetOneIte(TaskSetType &taskSetType) {
         int N = taskSetType.tasks_.size();
+        OptimizationContext &context = CurrentOptimizationContext();
 
         // this function also checks schedulability
         Schedul_Analysis r(taskSetType);
@@ -459,7 +504,7 @@ class Energy_Opt {
             return -2;
 
         VectorDynamic initialExecutionTime =
-            GetParameterVD<int>(taskSetType, "executionTimeOrg");
+            GetParameterVD<int, &Task::executionTimeOrg>(taskSetType);
 
         int lastTaskDoNotNeedOptimize = -1;
 
@@ -467,7 +512,7 @@ class Energy_Opt {
             taskSetType, -1, responseTimeInitial, eliminateTol);
 
         // computationTimeVectorLocalOpt is always stored in tasks
-        vectorGlobalOpt = initialExecutionTime;
+        context.vectorGlobalOpt = initialExecutionTime;
         int numberOfIteration = 0;
         // eliminateTolIte must be inherited from one iteration to its next,
         // otherwise, circular elimination will occur
@@ -489,23 +534,25 @@ class Energy_Opt {
                                  initialEstimateDuringOpt, responseTimeInitial);
 
             // formulate new computationTime
-            UpdateTaskSetExecutionTime(taskSetType.tasks_, vectorGlobalOpt);
+            UpdateTaskSetExecutionTime(taskSetType.tasks_,
+                                       context.vectorGlobalOpt);
             // clamp with rough option seems to work better
             ClampComputationTime(taskSetType, lastTaskDoNotNeedOptimize,
                                  responseTimeInitial, clampTypeMiddle);
             // update vectorGlobalOpt to be the clamped version
-            vectorGlobalOpt =
-                GetParameterVD<double>(taskSetType.tasks_, "executionTime");
-            valueGlobalOpt =
+            context.vectorGlobalOpt =
+                GetParameterVD<double, &Task::executionTime>(
+                    taskSetType.tasks_);
+            context.valueGlobalOpt =
                 EstimateEnergyTaskSet(taskSetType.tasks_).sum() / weightEnergy;
             if (debugMode == 1) {
                 std::cout << "After clamp: " << std::endl
-                          << GetParameterVD<double>(taskSetType.tasks_,
-                                                    "executionTime")
+                          << GetParameterVD<double, &Task::executionTime>(
+                                 taskSetType.tasks_)
                           << std::endl;
                 Schedul_Analysis r(taskSetType);
                 std::cout << "Execution time of tasks: " << std::endl;
-                std::cout << vectorGlobalOpt << std::endl;
+                std::cout << context.vectorGlobalOpt << std::endl;
                 VectorDynamic rtaTemp = r.ResponseTimeOfTaskSet();
                 std::cout << "RTA after optimization: " << rtaTemp << std::endl;
             }
@@ -534,6 +581,8 @@ class Energy_Opt {
             lastTaskDoNotNeedOptimize = lastTaskDoNotNeedOptimizeAfterOpt;
 
             numberOfIteration++;
+            if (context.TimeOut())
+                break;
             if (numberOfIteration > min(N, elimIte)) {
                 // CoutWarning("numberOfIteration reaches the maximum limits,
                 // the algorithm decides to give up!");
@@ -571,7 +620,7 @@ class Energy_Opt {
             }
             if (debugMode >= 1) {
                 double granularity =
-                    GetParameterVD<double>(taskSetType, "executionTime")
+                    GetParameterVD<double, &Task::executionTime>(taskSetType)
                         .maxCoeff() *
                     3e-5;
                 // verify whether elimination is successful
@@ -616,18 +665,20 @@ class Energy_Opt {
     }
 
     /**
-     * initialize all the global variables
+     * initialize all the variables of context, which becomes the current
+     * OptimizationContext during the optimization
      */
-    static double OptimizeTaskSet(TaskSetType &taskSetType) {
-        InitializeGlobalVector(taskSetType.tasks_.size());
-        double eliminateTolRef = eliminateTol;
+    static double OptimizeTaskSet(
+        TaskSetType &taskSetType,
+        OptimizationContext &context = CurrentOptimizationContext()) {
+        OptimizationContextScope scope(context);
+        context.InitializeGlobalVector(taskSetType.tasks_.size());
 
         double res = OptimizeTaskSetOneIte(taskSetType);
         std::cout << "After optimization: " << res << std::endl;
         // Some variables become 0, which actually means a failure
         if (isinf(res))
             res = 10;
-        eliminateTol = eliminateTolRef;
         return res;
     }
 };
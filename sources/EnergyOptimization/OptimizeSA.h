@@ -13,12 +13,11 @@ template <class TaskSetType, class Schedul_Analysis>
 OptimizeResult OptimizeSchedulingSA(TaskSetType &tasks) {
     srand(0);
     int N = tasks.tasks_.size();
-    TASK_NUMBER = N;
-    vectorGlobalOpt.resize(N, 1);
-    vectorGlobalOpt.setZero();
+    InitializeGlobalVector(N);
     int lastTaskDoNotNeedOptimize = -1;
-    VectorDynamic initialEstimate = GetParameterVD<int>(tasks, "executionTime");
-    VectorDynamic periods = GetParameterVD<int>(tasks, "period");
+    VectorDynamic initialEstimate =
+        GetParameterVD<int, &Task::executionTime>(tasks);
+    VectorDynamic periods = GetParameterVD<int, &Task::period>(tasks);
     Schedul_Analysis r(tasks);
     VectorDynamic responseTimeInitial = r.ResponseTimeOfTaskSet();
 
@@ -13,7 +13,10 @@
 #include "gtsam/linear/NoiseModel.h"
 #include "sources/EnergyOptimization/FGEnergyOptUtils.h"
 #include "sources/RTA/RTA_BASE.h"
+#include "sources/RTA/RTA_LL_Batch.h"
+#include "sources/RTA/RTA_LL_Incremental.h"
 #include "sources/Utils/GlobalVariables.h"  // EliminationRecord
+#include "sources/Utils/JacobianBatch.h"
 #include "sources/Utils/MultiKeyFactor.h"
 #include "sources/Utils/Parameters.h"
 #include "sources/Utils/utils.h"
@@ -26,6 +29,8 @@ class RTARelatedFactor : public gtsam::NoiseModelFactor {
     TaskSetType tasks;
     std::vector<gtsam::Symbol> keyVec;
     LambdaMultiKey f_with_RTA;
+    // evaluates f_with_RTA on all the perturbed points of a Jacobian
+    LambdaMultiKeyBatch f_with_RTA_batch;
 
     RTARelatedFactor(std::vector<gtsam::Symbol> &keyVec, TaskSetType &tasks,
                      gtsam::SharedNoiseModel model)
@@ -46,31 +51,80 @@ class RTARelatedFactor : public gtsam::NoiseModelFactor {
             EndTimer("f_with_RTA");
             return error;
         };
+        if (Schedul_Analysis::type() == "LL") {
+            // all the perturbed task sets are analyzed together
+            f_with_RTA_batch = [tasks](const std::vector<gtsam::Values> &xs) {
+                BeginTimer("f_with_RTA_batch");
+                std::vector<TaskSet> taskSets;
+                taskSets.reserve(xs.size());
+                for (const gtsam::Values &x : xs) {
+                    TaskSetType tasksCurr = tasks;
+                    UpdateTaskSetExecutionTime(
+                        tasksCurr, EnergyOptUtils::ExtractResults(x, tasks));
+                    taskSets.push_back(tasksCurr.tasks_);
+                }
+                std::vector<bool> schedulable =
+                    RTA_LL_Batch(taskSets).CheckSchedulability();
+                std::vector<VectorDynamic> errors(xs.size());
+                for (uint k = 0; k < xs.size(); k++) {
+                    errors[k] = GenerateVectorDynamic(1);
+                    errors[k](0) = schedulable[k] ? 0 : Barrier(-1e9);
+                }
+                EndTimer("f_with_RTA_batch");
+                return errors;
+            };
+        } else
+            f_with_RTA_batch = GenerateBatchEvaluator(
+                f_with_RTA, ParallelJacobian(Schedul_Analysis::type()));
     }
 
     gtsam::Vector unwhitenedError(const gtsam::Values &x,
                                   boost::optional<std::vector<gtsam::Matrix> &>
                                       H = boost::none) const override {
         BeginTimer("RTARelatedFactor_unwhitenedError");
+        gtsam::Vector err = f_with_RTA(x);
         if (H) {
-            for (uint i = 0; i < keyVec.size(); i++) {
-                if (exactJacobian) {
-                    NormalErrorFunction1D f = [x, i,
-                                               this](const VectorDynamic xi) {
-                        gtsam::Symbol a = keyVec.at(i);
-                        gtsam::Values xx = x;
-                        xx.update(a, xi);
-                        return f_with_RTA(xx);
-                    };
-                    (*H)[i] = NumericalDerivativeDynamic(
-                        f, x.at<VectorDynamic>(keyVec[i]), deltaOptimizer);
-                } else
+            if (exactJacobian) {
+                *H = NumericalDerivativeMultiKeyBatch(
+                    f_with_RTA_batch, x, keyVec, deltaOptimizer, err.rows(),
+                    FindKeysWithoutInfluence(x));
+            } else {
+                for (uint i = 0; i < keyVec.size(); i++)
                     (*H)[i] = GenerateVectorDynamic(1);
             }
         }
 
         EndTimer("RTARelatedFactor_unwhitenedError");
-        return f_with_RTA(x);
+        return err;
+    }
+
+    /**
+     * @brief keys whose perturbation cannot change f_with_RTA(x).
+     *
+     * For RTA_LL, the response time of task i only depends on the tasks with
+     * higher priority, i.e., tasks 0, ..., i-1. If task u is the first
+     * unschedulable task, perturbing the execution time of any task after u
+     * cannot make u schedulable, and so f_with_RTA remains unchanged.
+     */
+    std::vector<bool> FindKeysWithoutInfluence(const gtsam::Values &x) const {
+        std::vector<bool> skipKey(keyVec.size(), false);
+        if (Schedul_Analysis::type() != "LL")
+            return skipKey;
+        TaskSetType tasksCurr = tasks;
+        UpdateTaskSetExecutionTime(tasksCurr,
+                                   EnergyOptUtils::ExtractResults(x, tasks));
+        RTA_LL_Incremental r(tasksCurr.tasks_);
+        int firstMiss = r.N;
+        for (int i = 0; i < r.N; i++) {
+            if (r.RTA_Common_Warm(i) > min(tasksCurr.tasks_[i].deadline,
+                                           tasksCurr.tasks_[i].period)) {
+                firstMiss = i;
+                break;
+            }
+        }
+        for (uint i = 0; i < keyVec.size(); i++)
+            skipKey[i] = AnalyzeKey(keyVec[i]) > firstMiss;
+        return skipKey;
     }
 };
 
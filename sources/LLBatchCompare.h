@@ -29,22 +29,24 @@ void BatchCompare(int N = -1) {
                 "/home/zephyr/Programming/Energy_Opt_NLP/TaskData/"
                 "task_number/" +
                 file;
+            // every task set is optimized with a fresh context
+            OptimizationContext context;
+            OptimizationContextScope scope(context);
             auto taskSet1 = ReadTaskSet(path, readTaskMode);
             TaskSetNormal tasksN(taskSet1);
             auto start = std::chrono::high_resolution_clock::now();
             double res;
-            ResetCallingTimes();
             // next project: consider generalized elimination?
             if (optimizerType == 6)  // IPM-Ifopt
             {
                 res = OptimizeEnergyIfopt<TaskSetNormal, RTA_LL>(tasksN);
             } else if (optimizerType <= 4)
-                res =
-                    Energy_Opt<TaskSetNormal, RTA_LL>::OptimizeTaskSet(tasksN);
+                res = Energy_Opt<TaskSetNormal, RTA_LL>::OptimizeTaskSet(
+                    tasksN, context);
             else
                 CoutError("Unrecognized optimizer type!");
 
-            size_t rtaCall = ReadCallingTimes();
+            size_t rtaCall = context.rtaCallingTimes;
             auto stop = std::chrono::high_resolution_clock::now();
             auto duration =
                 std::chrono::duration_cast<std::chrono::microseconds>(stop -
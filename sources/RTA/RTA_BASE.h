@@ -1,22 +1,38 @@
 #pragma once
 
+#include <typeinfo>
+
 #include "sources/MatrixConvenient.h"
+#include "sources/RTA/SchedulabilityCache.h"
 #include "sources/TaskModel/TaskSetNormal.h"
 #include "sources/TaskModel/Tasks.h"
 #include "sources/Tools/profilier.h"
+#include "sources/Utils/OptimizationContext.h"
 
 // @brief All customized TaskSetType must inherit from TaskSetNormal in Tasks.h
 namespace rt_num_opt {
-size_t rtaCallingTimes;
-size_t rtaControl;
+// RTA counters of the current OptimizationContext
 inline void ResetCallingTimes() {
-    rtaCallingTimes = 0;
-    rtaControl = 0;
+    CurrentOptimizationContext().ResetCallingTimes();
+}
+inline void AddRTAControl(size_t calls) {
+    CurrentOptimizationContext().rtaControl += calls;
+    if (currentRTAControlCalls != nullptr)
+        *currentRTAControlCalls += calls;
+}
+inline void IncrementRTAControl() { AddRTAControl(1); }
+inline void IncrementCallingTimes() {
+    if (currentProbeRTACalls != nullptr)
+        (*currentProbeRTACalls)++;
+    else
+        CurrentOptimizationContext().rtaCallingTimes++;
+}
+inline size_t ReadCallingTimes() {
+    return CurrentOptimizationContext().rtaCallingTimes;
+}
+inline size_t ReadRTAControl() {
+    return CurrentOptimizationContext().rtaControl;
 }
-inline void IncrementRTAControl() { rtaControl++; }
-inline void IncrementCallingTimes() { rtaCallingTimes++; }
-inline size_t ReadCallingTimes() { return rtaCallingTimes; }
-inline size_t ReadRTAControl() { return rtaControl; }
 
 inline VectorDynamic GenerateInvalidRTA(int n) {
     VectorDynamic rta = GenerateVectorDynamic(n);
@@ -73,10 +89,24 @@ class RTA_BASE {
 
     VectorDynamic ResponseTimeOfTaskSet() {
         BeginTimer("ResponseTimeOfTaskSet");
-
-        VectorDynamic warmStart =
-            GetParameterVD<double>(tasks, "executionTime");
-        auto res = ResponseTimeOfTaskSet(warmStart);
+        SchedulabilityCache &cache = SchedulabilityCache::Instance();
+        uint64_t key = cache.Enabled() ? CacheKey("ResponseTimeOfTaskSet") : 0;
+        VectorDynamic res, entry;
+        if (cache.Enabled() && cache.Find(key, entry)) {
+            IncrementCallingTimes();
+            res = entry.head(entry.rows() - 1);
+            AddRTAControl(entry(entry.rows() - 1));
+        } else {
+            VectorDynamic warmStart =
+                GetParameterVD<double, &Task::executionTime>(tasks);
+            size_t rtaControl = 0;
+            {
+                RTAControlScope scope(rtaControl);
+                res = ResponseTimeOfTaskSet(warmStart);
+            }
+            if (cache.Enabled())
+                cache.Insert(key, CacheEntry(res, rtaControl));
+        }
         EndTimer("ResponseTimeOfTaskSet");
         return res;
     }
@@ -122,9 +152,44 @@ class RTA_BASE {
     }
 
     bool CheckSchedulability(bool whetherPrint = false) {
+        SchedulabilityCache &cache = SchedulabilityCache::Instance();
+        // the prints are not cached
+        bool useCache = cache.Enabled() && !whetherPrint;
+        uint64_t key = useCache ? CacheKey("CheckSchedulability") : 0;
+        VectorDynamic entry;
+        if (useCache && cache.Find(key, entry)) {
+            IncrementCallingTimes();
+            AddRTAControl(entry(1));
+            return entry(0) == 1;
+        }
         VectorDynamic warmStart =
-            GetParameterVD<double>(tasks.tasks_, "executionTime");
-        return CheckSchedulability(warmStart, whetherPrint);
+            GetParameterVD<double, &Task::executionTime>(tasks.tasks_);
+        size_t rtaControl = 0;
+        bool schedulable;
+        {
+            RTAControlScope scope(rtaControl);
+            schedulable = CheckSchedulability(warmStart, whetherPrint);
+        }
+        if (useCache)
+            cache.Insert(key, CacheEntry(GenerateVectorDynamic1D(schedulable),
+                                         rtaControl));
+        return schedulable;
+    }
+
+    // key of the result named kind in SchedulabilityCache; the results of
+    // the cold-start analyses only depend on the type of analysis and tasks
+    uint64_t CacheKey(const std::string &kind) const {
+        return SchedulabilityCache::Key(
+            tasks.Fingerprint(), std::string(typeid(*this).name()) + kind);
+    }
+
+    // a cached result followed by the rtaControl count of computing it, so
+    // that a hit counts the same as the analysis it replaces
+    static VectorDynamic CacheEntry(const VectorDynamic &res,
+                                    size_t rtaControl) {
+        VectorDynamic entry(res.rows() + 1);
+        entry << res, double(rtaControl);
+        return entry;
     }
 
     bool CheckSchedulabilityDirect(const VectorDynamic &rta) {
@@ -2,38 +2,50 @@
 
 #include "sources/MatrixConvenient.h"
 #include "sources/RTA/RTA_BASE.h"
+#include "sources/RTA/RTA_LL_Kernel.h"
 #include "sources/TaskModel/TaskSetNormal.h"
+#include "sources/TaskModel/TaskSetSoA.h"
 namespace rt_num_opt {
 class RTA_LL : public RTA_BASE<TaskSetNormal> {
    public:
+    TaskSetSoA tasksSoA;
     RTA_LL(const TaskSet &tasksI) {
         TaskSetNormal tasksN(tasksI);
         tasks = tasksN;
+        tasksSoA.Update(tasks);
     }
-    RTA_LL(const TaskSetNormal &tasks) : RTA_BASE(tasks) {}
+    RTA_LL(const TaskSetNormal &tasks) : RTA_BASE(tasks), tasksSoA(tasks) {}
 
     double RTA_Common_Warm(double beginTime, int index) override {
         IncrementRTAControl();
-        TaskSet tasksHp;
-        for (int i = 0; i < index; i++) {
-            tasksHp.push_back(tasks.tasks_.at(i));
+        if (Utilization(tasksSoA, index) +
+                tasks.tasks_.at(index).utilization() >
+            1.0 + 1e-6) {
+            return INT32_MAX;
         }
-        return ResponseTimeAnalysisWarm(beginTime, tasks.tasks_.at(index),
-                                        tasksHp);
+        return ResponseTimeAnalysisWarm_util_nece(
+            beginTime, tasksSoA.wcet[index], tasksSoA.period[index],
+            tasksSoA.period.data(), tasksSoA.wcet.data(), index);
     }
 
     // the rest are helper functions
     static std::string type() { return "LL"; }
 
-    double ResponseTimeAnalysisWarm_util_nece(
-        double beginTime, const Task &taskCurr,
-        const TaskSet &tasksHighPriority) {
-        const std::vector<int> periodHigh =
-            GetParameter<int>(tasksHighPriority, "period");
-        const std::vector<double> executionTimeHigh =
-            GetParameter<double>(tasksHighPriority, "executionTime");
-        int N = periodHigh.size();
+    // utilization of the first N tasks, periods are truncated as integers
+    static double Utilization(const TaskSetSoA &tasksSoA, int N) {
+        double utilization = 0;
+        for (int i = 0; i < N; i++)
+            utilization += tasksSoA.wcet[i] / int(tasksSoA.period[i]);
+        return utilization;
+    }
 
+    /**
+     * @brief fixed-point iteration of the response time; the N higher
+     * priority tasks are given as contiguous arrays
+     */
+    static double ResponseTimeAnalysisWarm_util_nece(
+        double beginTime, double executionTimeCurr, double periodCurr,
+        const double *periodHigh, const double *executionTimeHigh, int N) {
         if (beginTime < 0) {
             if (debugMode == 1) {
                 CoutWarning(
@@ -41,15 +53,16 @@ class RTA_LL : public RTA_BASE<TaskSetNormal> {
             }
             beginTime = 0;
         }
-        if (isnan(taskCurr.executionTime) || isnan(beginTime)) {
+        if (isnan(executionTimeCurr) || isnan(beginTime)) {
             std::cout << Color::red << "Nan executionTime detected" << def
                       << std::endl;
             throw "Nan";
         }
-        if (taskCurr.executionTime < 0) {
+        if (executionTimeCurr < 0) {
             return INT32_MAX;
         }
-        for (int i = 0; i < int(executionTimeHigh.size()); i++) {
+        double utilAll = 0;
+        for (int i = 0; i < N; i++) {
             if (executionTimeHigh[i] < 0) {
                 if (debugMode) {
                     CoutWarning(
@@ -57,14 +70,14 @@ class RTA_LL : public RTA_BASE<TaskSetNormal> {
                 }
                 return INT32_MAX;
             }
+            utilAll += executionTimeHigh[i] / int(periodHigh[i]);
         }
-        double utilAll = Utilization(tasksHighPriority);
         if (utilAll >= 1.0 - utilTol) {
             // cout << "The given task set is unschedulable\n";
             return INT32_MAX;
         }
-        for (uint i = 0; i < tasksHighPriority.size(); i++) {
-            if (tasksHighPriority[i].period < 0) return INT32_MAX;
+        for (int i = 0; i < N; i++) {
+            if (periodHigh[i] < 0) return INT32_MAX;
         }
 
         bool stop_flag = false;
@@ -72,14 +85,12 @@ class RTA_LL : public RTA_BASE<TaskSetNormal> {
         double responseTimeBefore = beginTime;
         int loopCount = 0;
         while (not stop_flag) {
-            double responseTime = taskCurr.executionTime;
-            for (int i = 0; i < N; i++)
-                responseTime +=
-                    ceil(responseTimeBefore / double(periodHigh[i])) *
-                    executionTimeHigh[i];
+            double responseTime =
+                InterferenceSum(responseTimeBefore, periodHigh,
+                                executionTimeHigh, N, executionTimeCurr);
             if (responseTime == responseTimeBefore) {
                 stop_flag = true;
-                if (responseTime > taskCurr.period) {
+                if (responseTime > periodCurr) {
                     return INT32_MAX;
                 }
                 return responseTime;
@@ -96,10 +107,21 @@ class RTA_LL : public RTA_BASE<TaskSetNormal> {
         throw;
     }
 
+    double ResponseTimeAnalysisWarm_util_nece(
+        double beginTime, const Task &taskCurr,
+        const TaskSet &tasksHighPriority) {
+        TaskSetSoA tasksHighSoA(tasksHighPriority);
+        return ResponseTimeAnalysisWarm_util_nece(
+            beginTime, taskCurr.executionTime, taskCurr.period,
+            tasksHighSoA.period.data(), tasksHighSoA.wcet.data(),
+            tasksHighSoA.N);
+    }
+
     double ResponseTimeAnalysisWarm(const double beginTime,
                                     const Task &taskCurr,
                                     const TaskSet &tasksHighPriority) {
-        if (Utilization(tasksHighPriority) + taskCurr.utilization() >
+        if (rt_num_opt::Utilization(tasksHighPriority) +
+                taskCurr.utilization() >
             1.0 + 1e-6) {
             return INT32_MAX;
         }
@@ -109,8 +131,6 @@ class RTA_LL : public RTA_BASE<TaskSetNormal> {
 
     double ResponseTimeAnalysis(const Task &taskCurr,
                                 const TaskSet &tasksHighPriority) {
-        const std::vector<double> executionTimeHigh =
-            GetParameter<double>(tasksHighPriority, "executionTime");
         double executionTimeAll = taskCurr.executionTime;
         for (auto &task : tasksHighPriority)
             executionTimeAll += task.executionTime;
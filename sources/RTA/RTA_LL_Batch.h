@@ -0,0 +1,162 @@
+/**
+ * @file RTA_LL_Batch.h
+ * @brief RTA_LL of many candidate task sets at once, such as the perturbed
+ * task sets of a numerical Jacobian. Each fixed-point iteration runs over all
+ * the candidates with Eigen's vectorized array operations; every candidate
+ * follows exactly the same iteration as RTA_LL with a cold start.
+ *
+ */
+#pragma once
+
+#include "sources/RTA/RTA_LL.h"
+namespace rt_num_opt {
+class RTA_LL_Batch {
+   public:
+    // (task, candidate), so that one task of all candidates is contiguous
+    typedef Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic,
+                         Eigen::RowMajor>
+        ArrayBatch;
+    typedef Eigen::Array<double, 1, Eigen::Dynamic> ArrayRow;
+    typedef Eigen::Array<bool, 1, Eigen::Dynamic> ArrayRowBool;
+
+    int N;  // number of tasks
+    int K;  // number of candidates
+    ArrayBatch period;
+    ArrayBatch periodInt;  // RTA_LL uses integer periods in interference
+    ArrayBatch executionTime;
+    ArrayBatch deadline;
+
+    RTA_LL_Batch(const std::vector<TaskSet> &taskSets) {
+        K = taskSets.size();
+        N = K > 0 ? taskSets[0].size() : 0;
+        Resize();
+        for (int k = 0; k < K; k++) {
+            if (int(taskSets[k].size()) != N)
+                CoutError("All the task sets in RTA_LL_Batch must have the "
+                          "same number of tasks!");
+            for (int i = 0; i < N; i++) SetTask(k, i, taskSets[k][i]);
+        }
+    }
+
+    // K copies of tasks, modified later by UpdateTaskSetParameter
+    RTA_LL_Batch(const TaskSet &tasks, int K) : N(tasks.size()), K(K) {
+        Resize();
+        for (int k = 0; k < K; k++)
+            for (int i = 0; i < N; i++) SetTask(k, i, tasks[i]);
+    }
+
+    void UpdateTaskSetParameter(int k, int index, double value,
+                                std::string parameter = "executionTime") {
+        if (parameter == "executionTime") {
+            executionTime(index, k) = value;
+        } else if (parameter == "period") {
+            period(index, k) = value;
+            periodInt(index, k) = int(value);
+        } else {
+            CoutError("Please provide Update parameter for " + parameter);
+        }
+    }
+
+    /**
+     * @brief response time of all the tasks in all the candidates
+     *
+     * @return MatrixDynamic (N, K), the k-th column is the same as
+     * RTA_LL(taskSets[k]).ResponseTimeOfTaskSet()
+     */
+    MatrixDynamic ResponseTimeOfTaskSet() {
+        BeginTimer("RTA_LL_Batch");
+        OptimizationContext &context = CurrentOptimizationContext();
+        context.rtaCallingTimes += K;
+        MatrixDynamic res = GenerateMatrixDynamic(N, K);
+        ArrayRow utilHp = ArrayRow::Zero(K);
+        ArrayRowBool invalidHp = ArrayRowBool::Constant(K, false);
+        for (int i = 0; i < N; i++) {
+            context.rtaControl += K;
+            res.row(i) = ResponseTimeOfTask(i, utilHp, invalidHp).matrix();
+            utilHp += executionTime.row(i) / periodInt.row(i);
+            invalidHp = invalidHp || (executionTime.row(i) < 0) ||
+                        (period.row(i) < 0);
+        }
+        EndTimer("RTA_LL_Batch");
+        return res;
+    }
+
+    /**
+     * @brief schedulability of every candidate, the same as
+     * RTA_LL(taskSets[k]).CheckSchedulability()
+     *
+     * @param tol: positive value, makes schedulability check more strict
+     */
+    std::vector<bool> CheckSchedulability(double tol = 0) {
+        MatrixDynamic rta = ResponseTimeOfTaskSet();
+        std::vector<bool> res(K, true);
+        for (int k = 0; k < K; k++) {
+            for (int i = 0; i < N; i++) {
+                if (rta(i, k) + tol > min(deadline(i, k), period(i, k))) {
+                    res[k] = false;
+                    break;
+                }
+            }
+        }
+        return res;
+    }
+
+   private:
+    void Resize() {
+        period.resize(N, K);
+        periodInt.resize(N, K);
+        executionTime.resize(N, K);
+        deadline.resize(N, K);
+    }
+
+    void SetTask(int k, int i, const Task &task) {
+        period(i, k) = task.period;
+        periodInt(i, k) = int(task.period);
+        executionTime(i, k) = task.executionTime;
+        deadline(i, k) = task.deadline;
+    }
+
+    // the same checks and iteration as RTA_LL::RTA_Common_Warm, with
+    // executionTime as warm start
+    ArrayRow ResponseTimeOfTask(int i, const ArrayRow &utilHp,
+                                const ArrayRowBool &invalidHp) {
+        ArrayRow executionTimeCurr = executionTime.row(i);
+        ArrayRow periodCurr = period.row(i);
+        ArrayRowBool active =
+            !(utilHp + executionTimeCurr / periodCurr > 1.0 + 1e-6);
+        if ((active && executionTimeCurr.isNaN()).any()) {
+            std::cout << Color::red << "Nan executionTime detected" << def
+                      << std::endl;
+            throw "Nan";
+        }
+        active = active && !(executionTimeCurr < 0) && !invalidHp &&
+                 !(utilHp >= 1.0 - utilTol);
+
+        ArrayRow res = ArrayRow::Constant(K, INT32_MAX);
+        ArrayRow responseTimeBefore = executionTimeCurr;
+        int loopCount = 0;
+        while (active.any()) {
+            ArrayRow responseTime = executionTimeCurr;
+            for (int j = 0; j < i; j++)
+                responseTime +=
+                    (responseTimeBefore / periodInt.row(j)).ceil() *
+                    executionTime.row(j);
+            ArrayRowBool converged =
+                active && (responseTime == responseTimeBefore);
+            res = (converged && responseTime <= periodCurr)
+                      .select(responseTime, res);
+            // iterations start below the fixed point and only increase, so
+            // the candidates exceeding their period are unschedulable already
+            active = active && !converged && responseTime <= periodCurr;
+            responseTimeBefore = responseTime;
+            loopCount++;
+            if (loopCount > 1500 && active.any()) {
+                CoutWarning("LoopCount error in RTA_LL_Batch");
+                break;
+            }
+        }
+        return res;
+    }
+};
+
+}  // namespace rt_num_opt
@@ -0,0 +1,225 @@
+/**
+ * @file RTA_LL_Incremental.h
+ * @brief Persistent version of RTA_LL for optimization loops that modify one
+ * task at a time. Periods and execution times are kept in contiguous arrays,
+ * and only the tasks whose priority is lower than or equal to the changed one
+ * are re-analyzed. The results are identical to RTA_LL with a cold start.
+ *
+ */
+#pragma once
+
+#include "sources/MatrixConvenient.h"
+#include "sources/RTA/RTA_BASE.h"
+#include "sources/RTA/RTA_LL_Kernel.h"
+#include "sources/TaskModel/TaskSetNormal.h"
+#include "sources/TaskModel/TaskSetSoA.h"
+namespace rt_num_opt {
+class RTA_LL_Incremental {
+   public:
+    RTA_LL_Incremental() : N(0), firstDirty_(0), firstColdStart_(0) {}
+    RTA_LL_Incremental(const TaskSet &tasks) { Reset(tasks); }
+    RTA_LL_Incremental(const TaskSetNormal &tasks) { Reset(tasks.tasks_); }
+
+    static std::string type() { return "LL"; }
+
+    void Reset(const TaskSet &tasks) {
+        N = tasks.size();
+        tasksSoA_.Update(tasks);
+        periodInt_.resize(N);
+        for (int i = 0; i < N; i++) periodInt_[i] = int(tasks[i].period);
+        utilPrefix_.assign(N + 1, 0);
+        executionNegativePrefix_.assign(N + 1, 0);
+        periodNegativePrefix_.assign(N + 1, 0);
+        fixedPoint_.assign(N, -1);
+        rta_.assign(N, INT32_MAX);
+        firstDirty_ = 0;
+        firstColdStart_ = N;
+    }
+
+    /**
+     * @brief Synchronize with tasks; only the differences are registered as
+     * deltas, so calling it with a task set that has just one task changed is
+     * as cheap as calling UpdateExecutionTime/UpdatePeriod directly
+     */
+    void UpdateTaskSet(const TaskSet &tasks) {
+        if (int(tasks.size()) != N) {
+            Reset(tasks);
+            return;
+        }
+        for (int i = 0; i < N; i++) {
+            if (tasks[i].executionTime != tasksSoA_.wcet[i])
+                UpdateExecutionTime(i, tasks[i].executionTime);
+            if (tasks[i].period != tasksSoA_.period[i])
+                UpdatePeriod(i, tasks[i].period);
+            if (tasks[i].deadline != tasksSoA_.deadline[i])
+                UpdateDeadline(i, tasks[i].deadline);
+        }
+    }
+    void UpdateTaskSet(const TaskSetNormal &tasks) {
+        UpdateTaskSet(tasks.tasks_);
+    }
+
+    void UpdateExecutionTime(int index, double value) {
+        if (value == tasksSoA_.wcet.at(index))
+            return;
+        // larger execution time never decreases the response time, and so the
+        // previous fixed points remain valid lower bounds
+        MarkDirty(index, value > tasksSoA_.wcet[index]);
+        tasksSoA_.wcet[index] = value;
+    }
+
+    void UpdatePeriod(int index, double value) {
+        if (value == tasksSoA_.period.at(index))
+            return;
+        MarkDirty(index, int(value) <= periodInt_[index]);
+        tasksSoA_.period[index] = value;
+        periodInt_[index] = int(value);
+    }
+
+    // deadlines are only used in the schedulability check
+    void UpdateDeadline(int index, double value) {
+        tasksSoA_.deadline.at(index) = value;
+    }
+
+    void UpdateTaskSetParameter(int index, double value,
+                                std::string parameter = "executionTime") {
+        if (parameter == "executionTime") {
+            UpdateExecutionTime(index, value);
+        } else if (parameter == "period") {
+            UpdatePeriod(index, value);
+        } else {
+            CoutError("Please provide Update parameter for " + parameter);
+        }
+    }
+
+    double RTA_Common_Warm(int index) {
+        Refresh(index);
+        return rta_[index];
+    }
+
+    VectorDynamic ResponseTimeOfTaskSet() {
+        IncrementCallingTimes();
+        Refresh(N - 1);
+        VectorDynamic res = GenerateVectorDynamic(N);
+        for (int i = 0; i < N; i++) res(i, 0) = rta_[i];
+        return res;
+    }
+
+    /**
+     * @brief same as RTA_BASE::CheckSchedulability; tasks after the first
+     * unschedulable one are not analyzed
+     *
+     * @param tol: positive value, makes schedulability check more strict
+     */
+    bool CheckSchedulability(bool whetherPrint = false, double tol = 0) {
+        IncrementCallingTimes();
+        for (int i = 0; i < N; i++) {
+            double rta = RTA_Common_Warm(i);
+            if (whetherPrint)
+                std::cout << "response time for task " << i << " is " << rta
+                          << " and deadline is "
+                          << min(tasksSoA_.deadline[i], tasksSoA_.period[i])
+                          << std::endl;
+            if (rta + tol > min(tasksSoA_.deadline[i], tasksSoA_.period[i])) {
+                if (whetherPrint) {
+                    std::cout << "The current task set is not schedulable "
+                                 "because of task "
+                              << i << " "
+                              << "!\n";
+                }
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int N;
+
+   private:
+    void MarkDirty(int index, bool loadIncrease) {
+        firstDirty_ = std::min(firstDirty_, index);
+        if (!loadIncrease)
+            firstColdStart_ = std::min(firstColdStart_, index);
+    }
+
+    // analyze all the dirty tasks up to index
+    void Refresh(int index) {
+        for (int i = firstDirty_; i <= index; i++) {
+            utilPrefix_[i + 1] =
+                utilPrefix_[i] + tasksSoA_.wcet[i] / periodInt_[i];
+            executionNegativePrefix_[i + 1] =
+                executionNegativePrefix_[i] || tasksSoA_.wcet[i] < 0;
+            periodNegativePrefix_[i + 1] =
+                periodNegativePrefix_[i] || tasksSoA_.period[i] < 0;
+            rta_[i] = AnalyzeTask(i, i >= firstColdStart_);
+        }
+        if (index >= firstDirty_) {
+            firstDirty_ = index + 1;
+            firstColdStart_ = std::max(firstColdStart_, index + 1);
+        }
+    }
+
+    // the same fixed-point iteration as RTA_LL::ResponseTimeAnalysisWarm
+    double AnalyzeTask(int index, bool coldStart) {
+        IncrementRTAControl();
+        double fixedPointPrev = fixedPoint_[index];
+        fixedPoint_[index] = -1;
+        double executionTimeCurr = tasksSoA_.wcet[index];
+        if (utilPrefix_[index] + executionTimeCurr / tasksSoA_.period[index] >
+            1.0 + 1e-6) {
+            return INT32_MAX;
+        }
+        if (isnan(executionTimeCurr)) {
+            std::cout << Color::red << "Nan executionTime detected" << def
+                      << std::endl;
+            throw "Nan";
+        }
+        if (executionTimeCurr < 0 || executionNegativePrefix_[index]) {
+            return INT32_MAX;
+        }
+        if (utilPrefix_[index] >= 1.0 - utilTol ||
+            periodNegativePrefix_[index]) {
+            return INT32_MAX;
+        }
+
+        double responseTimeBefore = executionTimeCurr;
+        if (!coldStart && fixedPointPrev > responseTimeBefore)
+            responseTimeBefore = fixedPointPrev;
+        int loopCount = 0;
+        while (true) {
+            double responseTime = InterferenceSum(
+                responseTimeBefore, tasksSoA_.period.data(),
+                tasksSoA_.wcet.data(), index, executionTimeCurr);
+            if (responseTime == responseTimeBefore) {
+                fixedPoint_[index] = responseTime;
+                if (responseTime > tasksSoA_.period[index]) {
+                    return INT32_MAX;
+                }
+                return responseTime;
+            } else {
+                responseTimeBefore = responseTime;
+            }
+            loopCount++;
+            if (loopCount > 1500) {
+                CoutWarning("LoopCount error in RTA_LL");
+                return INT32_MAX;
+            }
+        }
+    }
+
+    TaskSetSoA tasksSoA_;
+    std::vector<int> periodInt_;  // RTA_LL uses integer periods in interference
+    // utilization and validity of tasks 0, ..., i-1
+    std::vector<double> utilPrefix_;
+    std::vector<char> executionNegativePrefix_;
+    std::vector<char> periodNegativePrefix_;
+    // converged fixed point of the last analysis, -1 if it did not converge
+    std::vector<double> fixedPoint_;
+    std::vector<double> rta_;
+    // tasks in [firstDirty_, N) need to be re-analyzed; tasks in
+    // [firstColdStart_, N) cannot warm start from fixedPoint_
+    int firstDirty_;
+    int firstColdStart_;
+};
+
+}  // namespace rt_num_opt
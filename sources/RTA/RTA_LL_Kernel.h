@@ -0,0 +1,98 @@
+/**
+ * @file RTA_LL_Kernel.h
+ * @brief Interference sum of the RTA_LL fixed-point iteration,
+ *      initial + sum_j ceil(R / int(T_j)) * C_j,
+ * over contiguous period/execution time arrays. AVX-512 or AVX2 is used when
+ * the compiler targets it (e.g., cmake -DUSE_MARCH_NATIVE=ON), otherwise the
+ * scalar loop is used.
+ *
+ * The vectorized versions add the terms in a different order than the scalar
+ * loop, so results may differ in the last bit when execution times are not
+ * integers; the fixed-point test is not affected because every iteration uses
+ * the same order.
+ */
+#pragma once
+
+#include <math.h>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace rt_num_opt {
+
+inline double InterferenceSumScalar(double responseTime, const double *period,
+                                    const double *executionTime, int N,
+                                    double initial = 0) {
+    double res = initial;
+    for (int i = 0; i < N; i++)
+        res += ceil(responseTime / double(int(period[i]))) * executionTime[i];
+    return res;
+}
+
+#if defined(__AVX512F__)
+inline double InterferenceSumAVX512(double responseTime, const double *period,
+                                    const double *executionTime, int N,
+                                    double initial = 0) {
+    __m512d rVec = _mm512_set1_pd(responseTime);
+    __m512d sumVec = _mm512_setzero_pd();
+    int i = 0;
+    for (; i + 8 <= N; i += 8) {
+        __m512d periodVec = _mm512_roundscale_pd(_mm512_loadu_pd(period + i),
+                                                 _MM_FROUND_TO_ZERO);
+        __m512d ratio = _mm512_roundscale_pd(_mm512_div_pd(rVec, periodVec),
+                                             _MM_FROUND_TO_POS_INF);
+        sumVec = _mm512_add_pd(
+            sumVec, _mm512_mul_pd(ratio, _mm512_loadu_pd(executionTime + i)));
+    }
+    double res = initial + _mm512_reduce_add_pd(sumVec);
+    return InterferenceSumScalar(responseTime, period + i, executionTime + i,
+                                 N - i, res);
+}
+#endif
+
+#if defined(__AVX2__)
+inline double InterferenceSumAVX2(double responseTime, const double *period,
+                                  const double *executionTime, int N,
+                                  double initial = 0) {
+    __m256d rVec = _mm256_set1_pd(responseTime);
+    __m256d sumVec = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + 4 <= N; i += 4) {
+        __m256d periodVec =
+            _mm256_round_pd(_mm256_loadu_pd(period + i),
+                            _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+        __m256d ratio =
+            _mm256_round_pd(_mm256_div_pd(rVec, periodVec),
+                            _MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC);
+        sumVec = _mm256_add_pd(
+            sumVec, _mm256_mul_pd(ratio, _mm256_loadu_pd(executionTime + i)));
+    }
+    __m128d sum2 = _mm_add_pd(_mm256_castpd256_pd128(sumVec),
+                              _mm256_extractf128_pd(sumVec, 1));
+    double res = initial + _mm_cvtsd_f64(
+                               _mm_add_sd(sum2, _mm_unpackhi_pd(sum2, sum2)));
+    return InterferenceSumScalar(responseTime, period + i, executionTime + i,
+                                 N - i, res);
+}
+#endif
+
+/**
+ * @brief initial + sum_{i<N} ceil(responseTime / int(period[i])) *
+ * executionTime[i]; periods must be non-negative
+ */
+inline double InterferenceSum(double responseTime, const double *period,
+                              const double *executionTime, int N,
+                              double initial = 0) {
+#if defined(__AVX512F__)
+    return InterferenceSumAVX512(responseTime, period, executionTime, N,
+                                 initial);
+#elif defined(__AVX2__)
+    return InterferenceSumAVX2(responseTime, period, executionTime, N, initial);
+#else
+    return InterferenceSumScalar(responseTime, period, executionTime, N,
+                                 initial);
+#endif
+}
+
+}  // namespace rt_num_opt
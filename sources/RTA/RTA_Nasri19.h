@@ -1,12 +1,17 @@
 #pragma once
 
+#include <atomic>
+
 #include "global/space.hpp"
 #include "io.hpp"
 #include "problem.hpp"
 #include "sources/RTA/RTA_BASE.h"
+#include "sources/RTA/RTA_Nasri19_Problem.h"
+#include "sources/RTA/RTA_Nasri19_Windows.h"
 #include "sources/TaskModel/DAG_Nasri19.h"
 #include "sources/Tools/profilier.h"
-#include "tbb/task_scheduler_init.h"
+#include "sources/Utils/AnalysisArena.h"
+#include "tbb/parallel_for.h"
 
 namespace rt_num_opt {
 /**
@@ -68,32 +73,268 @@ class RTA_Nasri19 : public RTA_BASE<DAG_Nasri19> {
         if (!IsTasksValid())
             return GenerateInvalidRTA(dagNasri_.tasks_.size());
 
+        SchedulabilityCache &cache = SchedulabilityCache::Instance();
+        uint64_t key = 0;
+        VectorDynamic rta;
+        if (cache.Enabled()) {
+            key = AnalysisCacheKey("RTA_Nasri19", time_out);
+            if (cache.Find(key, rta))
+                return rta;
+        }
+
         BeginTimer(__func__);
         // prepare input
-        std::stringstream tasksInput;
-        tasksInput << dagNasri_.ConvertTasksetToCsv(debugMode == 1);
-        std::stringstream dagInput;
-        dagInput << dagNasri_.convertDAGsToCsv(debugMode == 1);
-        std::stringstream abortsInput;
-        tbb::task_scheduler_init init(tbb::task_scheduler_init::automatic);
-
-        NP::Scheduling_problem<dtime_t> problem{
-            NP::parse_file<dtime_t>(tasksInput), NP::parse_dag_file(dagInput),
-            NP::parse_abort_file<dtime_t>(abortsInput),
-            static_cast<unsigned int>(rt_num_opt::core_m_dag)};
-
-        // Set common analysis options
+        if (debugMode == 1) {
+            dagNasri_.ConvertTasksetToCsv(true);
+            dagNasri_.convertDAGsToCsv(true);
+        }
+        PooledNasri19Problem builder;
+        const NP::Scheduling_problem<dtime_t> &problem = builder->Build(
+            dagNasri_, static_cast<unsigned int>(rt_num_opt::core_m_dag));
+
+        NP::Analysis_options opts = AnalysisOptions(problem, time_out);
+
+        bool interrupted = false;
+        std::vector<NP::Scheduling_problem<dtime_t>> windows =
+            IdleWindows(problem);
+        if (!windows.empty()) {
+            ExploreWindows(windows, time_out, false, rta, interrupted);
+        } else {
+            // Actually call the analysis engine, in the persistent arena
+            std::unique_ptr<Checkpoints> checkpoints =
+                std::move(LastCheckpoints());
+            AnalysisArena::Instance().Execute([&]() {
+                auto space = Explore(problem, opts, checkpoints);
+                rta = ExtractRTA(space, problem);
+                interrupted = Interrupted(space);
+                CountAnalysis(space);
+            });
+            LastCheckpoints() = std::move(checkpoints);
+        }
+        // a time-out may not happen again, so it is not remembered
+        if (!interrupted)
+            cache.Insert(key, rta);
+        EndTimer(__func__);
+        return rta;
+    }
+
+    /**
+     * @brief key of the result named kind in SchedulabilityCache; besides the
+     * task set and the time-out, it covers every option of the exploration
+     */
+    uint64_t AnalysisCacheKey(const std::string &kind, double time_out) const {
+        Fingerprint64 fingerprint;
+        fingerprint.Add(dagNasri_.Fingerprint())
+            .Add(rt_num_opt::Nasri19Param_max_depth)
+            .Add(rt_num_opt::Nasri19Param_memoryBudget)
+            .Add(rt_num_opt::Nasri19Param_symmetryReduction)
+            .Add(rt_num_opt::Nasri19Param_idleWindows)
+            .Add(rt_num_opt::Nasri19Param_incremental);
+        return SchedulabilityCache::Key(fingerprint.Value(), kind, time_out);
+    }
+
+    // whether the exploration stopped before it found the answer
+    template <class StateSpace>
+    static bool Interrupted(const StateSpace &space) {
+        return space.was_timed_out() || space.was_out_of_memory();
+    }
+
+    // Set common analysis options
+    NP::Analysis_options AnalysisOptions(
+        const NP::Scheduling_problem<dtime_t> &problem, double time_out) {
         NP::Analysis_options opts;
         opts.timeout = time_out;
         opts.max_depth = rt_num_opt::Nasri19Param_max_depth;
         opts.early_exit = true;
         opts.num_buckets = problem.jobs.size();
         opts.be_naive = 0;
+        opts.memory_budget =
+            rt_num_opt::Nasri19Param_memoryBudget * 1024 * 1024;
+        opts.symmetry_reduction =
+            rt_num_opt::Nasri19Param_symmetryReduction == 1;
+        return opts;
+    }
+
+    bool HasConstrainedDeadlines() const {
+        for (const Task &task_curr : dagNasri_.tasks_)
+            if (task_curr.deadline > task_curr.period)
+                return false;
+        return true;
+    }
+
+    /**
+     * @brief the same as CheckSchedulabilityDirect(ResponseTimeOfTaskSet(
+     * time_out)), but the analysis keeps no response times and stops at the
+     * first deadline miss
+     */
+    bool SchedulabilityOnly(double time_out) {
+        // with deadlines beyond the periods, CheckSchedulabilityDirect also
+        // compares the response times with the periods
+        if (!HasConstrainedDeadlines())
+            return CheckSchedulabilityDirect(ResponseTimeOfTaskSet(time_out));
+        IncrementCallingTimes();
+        if (dagNasri_.IsHyperPeriodOverflow() ||
+            dagNasri_.GetTotalJobsWithinHyperPeriod() >
+                rt_num_opt::Job_Limit_Scheduling ||
+            !IsTasksValid())
+            return false;
 
-        // Actually call the analysis engine
-        auto space = NP::Global::State_space<dtime_t>::explore(problem, opts);
+        SchedulabilityCache &cache = SchedulabilityCache::Instance();
+        uint64_t key = 0;
+        VectorDynamic res;
+        if (cache.Enabled()) {
+            // the response times are as good, if they are known already
+            if (cache.Find(AnalysisCacheKey("RTA_Nasri19", time_out), res))
+                return CheckSchedulabilityDirect(res);
+            key = AnalysisCacheKey("RTA_Nasri19::SchedulabilityOnly", time_out);
+            if (cache.Find(key, res))
+                return res(0) != 0;
+        }
+
+        BeginTimer(__func__);
+        PooledNasri19Problem builder;
+        const NP::Scheduling_problem<dtime_t> &problem = builder->Build(
+            dagNasri_, static_cast<unsigned int>(rt_num_opt::core_m_dag));
+        NP::Analysis_options opts = AnalysisOptions(problem, time_out);
+        opts.schedulability_only = true;
+
+        bool schedulable = false, interrupted = false;
+        std::vector<NP::Scheduling_problem<dtime_t>> windows =
+            IdleWindows(problem);
+        if (!windows.empty()) {
+            schedulable =
+                ExploreWindows(windows, time_out, true, res, interrupted);
+        } else {
+            std::unique_ptr<Checkpoints> checkpoints =
+                std::move(LastCheckpoints());
+            AnalysisArena::Instance().Execute([&]() {
+                auto space = Explore(problem, opts, checkpoints);
+                schedulable = space.is_schedulable();
+                interrupted = Interrupted(space);
+                CountAnalysis(space);
+            });
+            LastCheckpoints() = std::move(checkpoints);
+        }
+        if (!interrupted)
+            cache.Insert(key, GenerateVectorDynamic1D(schedulable));
+        EndTimer(__func__);
+        return schedulable;
+    }
+
+    typedef NP::Global::Exploration_checkpoints<dtime_t> Checkpoints;
+
+    /**
+     * @brief the exploration fronts kept by the last analysis of this thread
+     * (Nasri19Param_incremental); an analysis takes them while it runs, as
+     * the thread may start another analysis while it waits inside the
+     * exploration of this one
+     */
+    static std::unique_ptr<Checkpoints> &LastCheckpoints() {
+        static thread_local std::unique_ptr<Checkpoints> last;
+        return last;
+    }
+
+    /**
+     * @brief explore the state space of problem; with
+     * Nasri19Param_incremental, resume from the checkpoints of the previous
+     * analysis where possible, and replace them with the new ones
+     */
+    NP::Global::State_space<dtime_t> Explore(
+        const NP::Scheduling_problem<dtime_t> &problem,
+        NP::Analysis_options opts, std::unique_ptr<Checkpoints> &checkpoints) {
+        if (rt_num_opt::Nasri19Param_incremental <= 0)
+            return NP::Global::State_space<dtime_t>::explore(problem, opts);
+        opts.checkpoints = rt_num_opt::Nasri19Param_incremental;
+        auto space = NP::Global::State_space<dtime_t>::explore(
+            problem, opts, checkpoints.get());
+        if (space.resumed_depth() > 0)
+            IncrementCounter("RTA_Nasri19 resumed analyses");
+        checkpoints.reset(new Checkpoints(space.take_checkpoints()));
+        return space;
+    }
 
-        // Extract the analysis results
+    /**
+     * @brief with Nasri19Param_idleWindows, the windows of problem between
+     * the instants at which the system is certainly idle, if there are
+     * several; none otherwise. The windows are explored from scratch, so the
+     * two options are exclusive: Nasri19Param_incremental only applies to
+     * the job sets that are not split
+     */
+    std::vector<NP::Scheduling_problem<dtime_t>> IdleWindows(
+        const NP::Scheduling_problem<dtime_t> &problem) {
+        std::vector<NP::Scheduling_problem<dtime_t>> windows;
+        if (rt_num_opt::Nasri19Param_idleWindows != 1)
+            return windows;
+        BeginTimer(__func__);
+        windows = SplitAtIdleInstants(problem);
+        if (windows.size() < 2)
+            windows.clear();
+        EndTimer(__func__);
+        return windows;
+    }
+
+    /**
+     * @brief analyze the windows of IdleWindows concurrently; they are all
+     * schedulable if the job set is, and the response time of a task is the
+     * largest in any window (rta is not computed with schedulability_only);
+     * interrupted tells whether the analysis of a window was, see Interrupted
+     */
+    bool ExploreWindows(
+        const std::vector<NP::Scheduling_problem<dtime_t>> &windows,
+        double time_out, bool schedulability_only, VectorDynamic &rta,
+        bool &interrupted) {
+        std::vector<VectorDynamic> window_rta(windows.size());
+        std::atomic<bool> unschedulable(false), window_interrupted(false);
+        // the windows map job ids concurrently, which only reads the tables
+        dagNasri_.UpdateJobOffsets();
+        AnalysisArena::Instance().Execute([&]() {
+            tbb::parallel_for(size_t(0), windows.size(), [&](size_t w) {
+                // the answer is known already
+                if (unschedulable)
+                    return;
+                NP::Analysis_options opts =
+                    AnalysisOptions(windows[w], time_out);
+                opts.schedulability_only = schedulability_only;
+                auto space = NP::Global::State_space<dtime_t>::explore(
+                    windows[w], opts);
+                if (!space.is_schedulable())
+                    unschedulable = true;
+                else if (!schedulability_only)
+                    window_rta[w] = ExtractRTA(space, windows[w]);
+                if (Interrupted(space))
+                    window_interrupted = true;
+                CountAnalysis(space);
+            });
+        });
+        interrupted = window_interrupted;
+        IncrementCounter("RTA_Nasri19 idle windows", windows.size());
+        if (unschedulable) {
+            rta = UnschedulableRTA(dagNasri_.tasks_.size());
+            return false;
+        }
+        rta = GenerateVectorDynamic(dagNasri_.tasks_.size());
+        if (!schedulability_only)
+            for (const VectorDynamic &r : window_rta)
+                rta = rta.cwiseMax(r);
+        return true;
+    }
+
+    // Profiler counters of an analysis run
+    template <class StateSpace>
+    void CountAnalysis(const StateSpace &space) {
+        // treated as unschedulable, like a time-out
+        if (space.was_out_of_memory())
+            IncrementCounter("RTA_Nasri19 out of memory budget");
+        auto stats = space.hash_statistics();
+        IncrementCounter("RTA_Nasri19 state lookups", stats.lookups);
+        IncrementCounter("RTA_Nasri19 state lookup probes", stats.probes);
+        IncrementCounter("RTA_Nasri19 state key collisions", stats.collisions);
+    }
+
+    // Extract the analysis results
+    template <class StateSpace>
+    VectorDynamic ExtractRTA(const StateSpace &space,
+                             const NP::Scheduling_problem<dtime_t> &problem) {
         // std::vector<double> rta(dagNasri_.tasks_.size(), INT32_MAX);
         VectorDynamic rta = GenerateVectorDynamic(dagNasri_.tasks_.size());
 
@@ -118,7 +359,6 @@ class RTA_Nasri19 : public RTA_BASE<DAG_Nasri19> {
         } else {
             rta = UnschedulableRTA(dagNasri_.tasks_.size());
         }
-        EndTimer(__func__);
         return rta;
     }
 
@@ -127,13 +367,10 @@ class RTA_Nasri19 : public RTA_BASE<DAG_Nasri19> {
         return CheckSchedulability();
     }
     bool CheckSchedulability(bool whetherPrint = false) {
-        VectorDynamic rta = ResponseTimeOfTaskSet();
-        return CheckSchedulabilityDirect(rta);
+        return SchedulabilityOnly(rt_num_opt::Nasri19Param_timeout);
     }
     bool CheckSchedulabilityLongTimeOut() {
-        VectorDynamic rta =
-            ResponseTimeOfTaskSet(rt_num_opt::Nasri19Param_timeout * 10);
-        return CheckSchedulabilityDirect(rta);
+        return SchedulabilityOnly(rt_num_opt::Nasri19Param_timeout * 10);
     }
 };
 
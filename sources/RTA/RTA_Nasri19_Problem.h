@@ -0,0 +1,167 @@
+/**
+ * @file RTA_Nasri19_Problem.h
+ * @brief Builds the NP::Scheduling_problem of a DAG_Nasri19 directly, without
+ * formatting it as CSV and parsing it again. The jobs and precedence
+ * constraints are identical to parsing ConvertTasksetToCsv and
+ * convertDAGsToCsv.
+ *
+ * A builder keeps its job vector between calls, and only rewrites the jobs
+ * that changed since the last call; builders are reused through a pool.
+ */
+#pragma once
+
+#include <memory>
+#include <mutex>
+
+#include "problem.hpp"
+#include "sources/TaskModel/DAG_Nasri19.h"
+#include "sources/Tools/profilier.h"
+
+namespace rt_num_opt {
+class Nasri19Problem {
+   public:
+    typedef NP::Scheduling_problem<dtime_t> Problem;
+
+    Nasri19Problem() : problem_(Problem::Workload(), 1) {}
+
+    /**
+     * @brief update the scheduling problem to the hyper-period job set of
+     * dagNasri; the returned reference is valid until the next call
+     */
+    const Problem &Build(DAG_Nasri19 &dagNasri,
+                         unsigned int num_processors = core_m_dag) {
+        BeginTimer(__func__);
+        dagNasri.UpdateTasksVecNasri_();
+        problem_.num_processors = num_processors;
+        BuildJobs(dagNasri);
+        BuildPrecedence(dagNasri);
+        EndTimer(__func__);
+        return problem_;
+    }
+
+   private:
+    // follows the same order and integer conversions as ConvertTasksetToCsv
+    void BuildJobs(const DAG_Nasri19 &dagNasri) {
+        Problem::Workload &jobs = problem_.jobs;
+        nodeFirstJob_.clear();
+        size_t globalId = 0;
+        for (size_t taskId = 0; taskId < dagNasri.tasksVecNasri_.size();
+             taskId++) {
+            const DAG_Model &dag = dagNasri.tasksVecNasri_[taskId];
+            for (size_t nodeId = 0; nodeId < dag.tasks_.size(); nodeId++) {
+                nodeFirstJob_.push_back(globalId);
+                const Task &task_curr = dag.tasks_[nodeId];
+                int period = task_curr.period;
+                for (size_t node_job_index = 0;
+                     node_job_index < size_t(dagNasri.hyperPeriod / period);
+                     node_job_index++) {
+                    int release = task_curr.offset + node_job_index * period;
+                    int deadline = release + task_curr.deadline;
+                    int priority = task_curr.priority;
+                    if (priority == -1)
+                        priority = deadline;
+                    SetJob(globalId++, taskId, release,
+                           int(task_curr.executionTime), deadline, priority);
+                }
+            }
+        }
+        if (jobs.size() > globalId)
+            jobs.erase(jobs.begin() + globalId, jobs.end());
+    }
+
+    void SetJob(size_t globalId, size_t taskId, dtime_t release, dtime_t cost,
+                dtime_t deadline, dtime_t priority) {
+        Problem::Workload &jobs = problem_.jobs;
+        if (globalId < jobs.size()) {
+            const NP::Job<dtime_t> &job = jobs[globalId];
+            if (job.get_task_id() == taskId &&
+                job.earliest_arrival() == release &&
+                job.latest_arrival() == release &&
+                job.least_cost() == cost && job.maximal_cost() == cost &&
+                job.get_deadline() == deadline &&
+                job.get_priority() == priority)
+                return;
+        }
+        NP::Job<dtime_t> job(globalId, Interval<dtime_t>{release, release},
+                             Interval<dtime_t>{cost, cost}, deadline, priority,
+                             taskId);
+        if (globalId < jobs.size())
+            jobs[globalId] = job;
+        else
+            jobs.push_back(job);
+    }
+
+    // follows convertDAGsToCsv; the job references are valid by construction
+    // and so are not validated again
+    void BuildPrecedence(const DAG_Nasri19 &dagNasri) {
+        NP::Precedence_constraints &edges = problem_.dag;
+        edges.clear();
+        size_t nodeOffset = 0;
+        for (uint taskId = 0; taskId < dagNasri.tasksVecNasri_.size();
+             taskId++) {
+            const DAG_Model &dag = dagNasri.tasksVecNasri_[taskId];
+            rt_num_opt::edge_iter ei, ei_end;
+            auto vertex2index_ = boost::get(boost::vertex_name, dag.graph_);
+            for (tie(ei, ei_end) = boost::edges(dag.graph_); ei != ei_end;
+                 ++ei) {
+                int fromJId = vertex2index_[boost::source(*ei, dag.graph_)];
+                int toJId = vertex2index_[boost::target(*ei, dag.graph_)];
+                size_t fromFirst = nodeFirstJob_[nodeOffset + fromJId];
+                size_t toFirst = nodeFirstJob_[nodeOffset + toJId];
+                for (uint taskIndex = 0;
+                     taskIndex < dagNasri.hyperPeriod / dag.tasks_[0].period;
+                     taskIndex++) {
+                    edges.emplace_back(
+                        NP::JobID(fromFirst + taskIndex, taskId),
+                        NP::JobID(toFirst + taskIndex, taskId));
+                }
+            }
+            nodeOffset += dag.tasks_.size();
+        }
+    }
+
+    Problem problem_;
+    // global id of the first job of every node, in the order of tasks_
+    std::vector<size_t> nodeFirstJob_;
+};
+
+/**
+ * @brief a Nasri19Problem borrowed from a global pool for the lifetime of this
+ * object; a thread may start another analysis while it waits inside the
+ * exploration of the previous one, so builders are not thread-local
+ */
+class PooledNasri19Problem {
+   public:
+    PooledNasri19Problem() {
+        std::lock_guard<std::mutex> lock(PoolMutex());
+        std::vector<std::unique_ptr<Nasri19Problem>> &pool = Pool();
+        if (pool.empty()) {
+            problem_.reset(new Nasri19Problem());
+        } else {
+            problem_ = std::move(pool.back());
+            pool.pop_back();
+        }
+    }
+    ~PooledNasri19Problem() {
+        std::lock_guard<std::mutex> lock(PoolMutex());
+        Pool().push_back(std::move(problem_));
+    }
+    PooledNasri19Problem(const PooledNasri19Problem &) = delete;
+    PooledNasri19Problem &operator=(const PooledNasri19Problem &) = delete;
+
+    Nasri19Problem *operator->() { return problem_.get(); }
+
+   private:
+    static std::vector<std::unique_ptr<Nasri19Problem>> &Pool() {
+        static std::vector<std::unique_ptr<Nasri19Problem>> pool;
+        return pool;
+    }
+    static std::mutex &PoolMutex() {
+        static std::mutex mtx;
+        return mtx;
+    }
+
+    std::unique_ptr<Nasri19Problem> problem_;
+};
+
+}  // namespace rt_num_opt
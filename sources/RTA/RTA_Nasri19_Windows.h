@@ -0,0 +1,107 @@
+/**
+ * @file RTA_Nasri19_Windows.h
+ * @brief Splits the job set of a Nasri19 analysis at the instants at which
+ * the system is certainly idle, so that the windows between them can be
+ * analyzed independently, and concurrently.
+ *
+ * Let the system be idle at the start of a window. An instant t after the
+ * releases of the jobs of the window is a cut point if
+ *  - no job released at or after t precedes a job of the window, and
+ *  - all the jobs of the window certainly finish by t. In a work-conserving
+ * schedule, they finish by R + L + (W - L) / m, where R is their latest
+ * release, W their total WCET, L the longest chain of WCETs among them, and
+ * m the number of cores: follow the chain of the job that finishes last
+ * backwards; whenever its current job waits neither for its release nor for
+ * a predecessor, it runs or all the cores are busy.
+ * The jobs released from t on then do not interfere with the window, and
+ * the precedence constraints from the window to them always hold.
+ */
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+
+#include "problem.hpp"
+
+namespace rt_num_opt {
+/**
+ * @brief the problems of the windows between the cut points of problem, in
+ * the order of time, with the jobs in their original order; a single one if
+ * there is no cut point
+ */
+inline std::vector<NP::Scheduling_problem<dtime_t>> SplitAtIdleInstants(
+    const NP::Scheduling_problem<dtime_t> &problem) {
+    typedef NP::Scheduling_problem<dtime_t> Problem;
+    const Problem::Workload &jobs = problem.jobs;
+    size_t n = jobs.size();
+    std::unordered_map<NP::JobID, size_t> indexOf;
+    for (size_t i = 0; i < n; i++) indexOf.emplace(jobs[i].get_id(), i);
+    std::vector<std::vector<size_t>> predecessors(n);
+    for (const auto &e : problem.dag)
+        predecessors[indexOf.at(e.second)].push_back(indexOf.at(e.first));
+
+    // the jobs by release, and the position of every job in this order
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return jobs[a].earliest_arrival() < jobs[b].earliest_arrival();
+    });
+    std::vector<size_t> position(n);
+    for (size_t p = 0; p < n; p++) position[order[p]] = p;
+
+    // the window starts at position first; chain[i] is the longest chain of
+    // WCETs in the window ending with job i, or -1 if not known yet
+    size_t first = 0;
+    std::vector<dtime_t> chain(n, -1);
+    std::function<dtime_t(size_t)> Chain = [&](size_t i) {
+        if (chain[i] < 0) {
+            dtime_t longest = 0;
+            for (size_t p : predecessors[i])
+                if (position[p] >= first)
+                    longest = std::max(longest, Chain(p));
+            chain[i] = longest + jobs[i].maximal_cost();
+        }
+        return chain[i];
+    };
+
+    std::vector<size_t> windowOf(n);
+    size_t numWindows = 1, lastPredecessor = 0, chained = 0;
+    dtime_t latestRelease = 0, work = 0, longest = 0;
+    const dtime_t m = problem.num_processors;
+    for (size_t p = 0; p < n; p++) {
+        size_t i = order[p];
+        windowOf[i] = numWindows - 1;
+        work += jobs[i].maximal_cost();
+        latestRelease = std::max(latestRelease, jobs[i].latest_arrival());
+        for (size_t q : predecessors[i])
+            lastPredecessor = std::max(lastPredecessor, position[q]);
+
+        // a cut point before the next release?
+        if (p + 1 == n || lastPredecessor > p) continue;
+        dtime_t next = jobs[order[p + 1]].earliest_arrival();
+        if (latestRelease + (work + m - 1) / m > next) continue;
+        // the predecessors of the jobs of the window are known now
+        for (; chained <= p; chained++)
+            longest = std::max(longest, Chain(order[chained]));
+        if (latestRelease + longest + (work - longest + m - 1) / m > next)
+            continue;
+        numWindows++;
+        first = chained = p + 1;
+        latestRelease = work = longest = 0;
+    }
+
+    std::vector<Problem> windows(numWindows,
+                                 Problem(Problem::Workload(),
+                                         problem.num_processors));
+    for (size_t i = 0; i < n; i++) windows[windowOf[i]].jobs.push_back(jobs[i]);
+    // the constraints to later windows always hold
+    for (const auto &e : problem.dag) {
+        size_t w = windowOf[indexOf.at(e.second)];
+        if (windowOf[indexOf.at(e.first)] == w) windows[w].dag.push_back(e);
+    }
+    return windows;
+}
+}  // namespace rt_num_opt
@@ -0,0 +1,119 @@
+/**
+ * @file SchedulabilityCache.h
+ * @brief Bounded LRU cache of analysis results, keyed by the 64-bit
+ * fingerprint of the task set (periods, WCETs, priorities, DAG edges, number
+ * of cores) and the kind of analysis. The optimizers analyze the same
+ * configuration many times, e.g., when a variable is disturbed and restored.
+ *
+ * Hits and misses are counted in the profiler, see PrintTimer.
+ */
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "sources/MatrixConvenient.h"
+#include "sources/Tools/Fingerprint.h"
+#include "sources/Tools/profilier.h"
+#include "sources/Utils/Parameters.h"
+
+namespace rt_num_opt {
+class SchedulabilityCache {
+   public:
+    explicit SchedulabilityCache(size_t capacity) : capacity_(capacity) {}
+
+    static SchedulabilityCache &Instance() {
+        static SchedulabilityCache cache(schedulabilityCacheSize);
+        return cache;
+    }
+
+    /**
+     * @brief cache key of an analysis result
+     *
+     * @param taskSetFingerprint: Fingerprint() of the task set
+     * @param analysis: name of the analysis and of the result, e.g.,
+     * "RTA_LL::ResponseTimeOfTaskSet"
+     * @param parameter: any other input of the analysis, e.g., a time-out
+     */
+    static uint64_t Key(uint64_t taskSetFingerprint,
+                        const std::string &analysis, double parameter = 0) {
+        Fingerprint64 fingerprint;
+        fingerprint.Add(taskSetFingerprint)
+            .Add(uint64_t(std::hash<std::string>{}(analysis)))
+            .Add(parameter);
+        return fingerprint.Value();
+    }
+
+    bool Enabled() const { return capacity_ > 0; }
+
+    // false if key is not cached; a hit makes key the most recently used one
+    bool Find(uint64_t key, VectorDynamic &value) {
+        bool hit = false;
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            auto itr = index_.find(key);
+            if (itr != index_.end()) {
+                entries_.splice(entries_.begin(), entries_, itr->second);
+                value = itr->second->second;
+                hit = true;
+            }
+        }
+        IncrementCounter(hit ? "SchedulabilityCache hit"
+                             : "SchedulabilityCache miss");
+        return hit;
+    }
+
+    void Insert(uint64_t key, const VectorDynamic &value) {
+        if (!Enabled())
+            return;
+        std::lock_guard<std::mutex> lock(mtx_);
+        auto itr = index_.find(key);
+        if (itr != index_.end()) {
+            itr->second->second = value;
+            entries_.splice(entries_.begin(), entries_, itr->second);
+            return;
+        }
+        entries_.emplace_front(key, value);
+        index_[key] = entries_.begin();
+        while (entries_.size() > capacity_) {
+            index_.erase(entries_.back().first);
+            entries_.pop_back();
+        }
+    }
+
+    // changes the capacity, and drops the least recently used entries
+    void SetCapacity(size_t capacity) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        capacity_ = capacity;
+        while (entries_.size() > capacity_) {
+            index_.erase(entries_.back().first);
+            entries_.pop_back();
+        }
+    }
+
+    void Clear() {
+        std::lock_guard<std::mutex> lock(mtx_);
+        entries_.clear();
+        index_.clear();
+    }
+
+    size_t ReadSize() {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return entries_.size();
+    }
+
+   private:
+    std::atomic<size_t> capacity_;
+    std::mutex mtx_;
+    // the most recently used entry first
+    std::list<std::pair<uint64_t, VectorDynamic>> entries_;
+    std::unordered_map<uint64_t,
+                       std::list<std::pair<uint64_t, VectorDynamic>>::iterator>
+        index_;
+};
+
+}  // namespace rt_num_opt
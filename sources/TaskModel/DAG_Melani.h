@@ -17,6 +17,15 @@ struct TaskSetDAG : public TaskSetNormal {
           longestVec_(longestVec),
           weightVec_(weight) {}
     static std::string Type() { return "dag"; }
+
+    uint64_t Fingerprint() const {
+        Fingerprint64 fingerprint;
+        AddToFingerprint(fingerprint);
+        for (size_t i = 0; i < volumeVec_.size(); i++)
+            fingerprint.Add(volumeVec_[i]).Add(longestVec_[i]);
+        fingerprint.Add(core_m_dag);
+        return fingerprint.Value();
+    }
 };
 
 TaskSetDAG ReadDAG_Tasks(std::string path, std::string priorityType = "orig") {
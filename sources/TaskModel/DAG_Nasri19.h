@@ -2,6 +2,8 @@
 // The task model is from the paper "Response-Time Analysis of
 // Limited-Preemptive Parallel DAG Tasks Under Global Scheduling"
 
+#include <algorithm>
+
 #include "sources/TaskModel/DAG_Task.h"
 #include "sources/TaskModel/ReadWriteYaml.h"
 
@@ -105,6 +107,7 @@ struct DAG_Nasri19 : public TaskSetNormal {
         }
         UpdateTasksFromVecNasri_();
         hyperPeriod = HyperPeriod(tasks_);
+        InvalidateJobOffsets();
     }
 
     void UpdateTasksFromVecNasri_() {
@@ -124,6 +127,7 @@ struct DAG_Nasri19 : public TaskSetNormal {
             tasksVecNasri_[i].RoundPeriod(possible_period);
         }
         for (Task &task_curr : tasks_) task_curr.RoundPeriod(possible_period);
+        InvalidateJobOffsets();
     }
 
     void UpdateTaskSet(const TaskSet &tasks) {
@@ -131,6 +135,7 @@ struct DAG_Nasri19 : public TaskSetNormal {
         UpdateTasksVecNasri_();
         RoundPeriod();
         hyperPeriod = HyperPeriod(tasks_);
+        InvalidateJobOffsets();
     }
 
     void UpdateTasksVecNasri_() {
@@ -141,6 +146,34 @@ struct DAG_Nasri19 : public TaskSetNormal {
                 tasksVecNasri_[taskId].tasks_[jobId] = tasks_[index++];
             }
         }
+        // tasks_ may carry new periods
+        InvalidateJobOffsets();
+    }
+
+    /**
+     * @brief the job ids below depend on the periods; call this after
+     * changing them other than through UpdatePeriod, UpdateTaskSet,
+     * RoundPeriod or UpdateTasksVecNasri_
+     */
+    void InvalidateJobOffsets() { jobOffsetsHyperPeriod_ = -1; }
+
+    /**
+     * @brief rebuild the prefix offsets behind IdJob2Global, IdsGlobal2Job
+     * and IdJobTaskLevel, if the periods changed since the last build
+     */
+    void UpdateJobOffsets() {
+        if (jobOffsetsHyperPeriod_ == hyperPeriod)
+            return;
+        dagFirstNode_.assign(1, 0);
+        nodeFirstJob_.assign(1, 0);
+        for (const DAG_Model &dag : tasksVecNasri_) {
+            dagFirstNode_.push_back(dagFirstNode_.back() + dag.tasks_.size());
+            for (const Task &task_curr : dag.tasks_)
+                nodeFirstJob_.push_back(
+                    nodeFirstJob_.back() +
+                    static_cast<size_t>(hyperPeriod / task_curr.period));
+        }
+        jobOffsetsHyperPeriod_ = hyperPeriod;
     }
 
     /**
@@ -181,18 +214,8 @@ struct DAG_Nasri19 : public TaskSetNormal {
      * @return int
      */
     int IdJob2Global(int taskId, int jobId, int taskIndex) {
-        int globalId = 0;
-        for (int i = 0; i < taskId; i++) {
-            for (size_t j = 0; j < tasksVecNasri_[i].tasks_.size(); j++) {
-                globalId += hyperPeriod / tasksVecNasri_[i].tasks_[j].period;
-            }
-        }
-
-        for (int j = 0; j < jobId; j++) {
-            globalId += hyperPeriod / tasksVecNasri_[taskId].tasks_[j].period;
-        }
-
-        return globalId + taskIndex;
+        UpdateJobOffsets();
+        return nodeFirstJob_[dagFirstNode_[taskId] + jobId] + taskIndex;
     }
 
     struct Ids {
@@ -202,21 +225,20 @@ struct DAG_Nasri19 : public TaskSetNormal {
     };
 
     Ids IdsGlobal2Job(size_t globalId) {
-        size_t taskId, jobId;
-        for (taskId = 0; taskId < tasksVecNasri_.size(); taskId++) {
-            for (jobId = 0; jobId < tasksVecNasri_[taskId].tasks_.size();
-                 jobId++) {
-                if (globalId >=
-                    hyperPeriod / tasksVecNasri_[taskId].tasks_[jobId].period) {
-                    globalId -= hyperPeriod /
-                                tasksVecNasri_[taskId].tasks_[jobId].period;
-                } else {
-                    return {taskId, jobId, globalId};
-                }
-            }
+        UpdateJobOffsets();
+        if (globalId >= nodeFirstJob_.back()) {
+            CoutError("Out-of-range in IdsGlobal2Job");
+            return {0, 0, 0};
         }
-        CoutError("Out-of-range in IdsGlobal2Job");
-        return {0, 0, 0};
+        // the last node and DAG that start at or before the given id
+        size_t node = std::upper_bound(nodeFirstJob_.begin(),
+                                       nodeFirstJob_.end(), globalId) -
+                      nodeFirstJob_.begin() - 1;
+        size_t taskId = std::upper_bound(dagFirstNode_.begin(),
+                                         dagFirstNode_.end(), node) -
+                        dagFirstNode_.begin() - 1;
+        return {taskId, node - dagFirstNode_[taskId],
+                globalId - nodeFirstJob_[node]};
     }
 
     /**
@@ -228,11 +250,8 @@ struct DAG_Nasri19 : public TaskSetNormal {
      * @return int
      */
     int IdJobTaskLevel(int taskId, int jobId) {
-        int id = 0;
-        for (int i = 0; i < taskId; i++) {
-            id += tasksVecNasri_[i].tasks_.size();
-        }
-        return id + jobId;
+        UpdateJobOffsets();
+        return dagFirstNode_[taskId] + jobId;
     }
 
     std::string ConvertTasksetToCsv(
@@ -311,6 +330,24 @@ struct DAG_Nasri19 : public TaskSetNormal {
         return dependStr;
     }
 
+    // task parameters, DAG edges and the number of cores
+    uint64_t Fingerprint() const {
+        Fingerprint64 fingerprint;
+        AddToFingerprint(fingerprint);
+        fingerprint.Add(hyperPeriod).Add(core_m_dag);
+        for (const DAG_Model &dag : tasksVecNasri_) {
+            fingerprint.Add(dag.tasks_.size());
+            rt_num_opt::edge_iter ei, ei_end;
+            auto vertex2index_ = boost::get(boost::vertex_name, dag.graph_);
+            for (tie(ei, ei_end) = boost::edges(dag.graph_); ei != ei_end;
+                 ++ei) {
+                fingerprint.Add(vertex2index_[boost::source(*ei, dag.graph_)])
+                    .Add(vertex2index_[boost::target(*ei, dag.graph_)]);
+            }
+        }
+        return fingerprint.Value();
+    }
+
     // data members
     long long int hyperPeriod;
     std::vector<rt_num_opt::DAG_Model>
@@ -318,6 +355,15 @@ struct DAG_Nasri19 : public TaskSetNormal {
     // std::vector<int> nodeSizes_;
     std::string dagCsv;
     std::vector<int> possible_period;
+
+   private:
+    // prefix offsets behind the job ids: the index in tasks_ of the first
+    // node of every DAG, and the global id of the first job of every node,
+    // each with the total at the end
+    std::vector<size_t> dagFirstNode_;
+    std::vector<size_t> nodeFirstJob_;
+    // the hyper-period they were built for, -1 after a change of periods
+    long long int jobOffsetsHyperPeriod_ = -1;
 };
 
 inline DAG_Nasri19 ReadDAGNasri19_Tasks(
@@ -15,6 +15,7 @@ std::vector<rt_num_opt::DAG_Model> ReadDAG_NasriFromYaml(std::string path) {
     }
 
     // read frequency ratio, if any
+    double &frequencyRatio = CurrentOptimizationContext().frequencyRatio;
     if (config["frequencyRatio"]) {
         frequencyRatio = config["frequencyRatio"].as<double>();
     } else {
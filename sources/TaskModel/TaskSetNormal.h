@@ -2,6 +2,7 @@
 
 #include "sources/TaskModel/DAG_Task.h"
 #include "sources/TaskModel/Tasks.h"
+#include "sources/Tools/Fingerprint.h"
 
 namespace rt_num_opt {
 struct TaskSetNormal {
@@ -33,6 +34,24 @@ struct TaskSetNormal {
     Task operator[](size_t i) { return tasks_[i]; }
 
     size_t size() { return tasks_.size(); }
+
+    // hash of all the task parameters that the analyses read, in priority order
+    void AddToFingerprint(Fingerprint64 &fingerprint) const {
+        fingerprint.Add(tasks_.size());
+        for (const Task &task : tasks_) {
+            fingerprint.Add(task.period)
+                .Add(task.executionTime)
+                .Add(task.executionTimeOrg)
+                .Add(task.deadline)
+                .Add(task.offset)
+                .Add(task.priority);
+        }
+    }
+    uint64_t Fingerprint() const {
+        Fingerprint64 fingerprint;
+        AddToFingerprint(fingerprint);
+        return fingerprint.Value();
+    }
 };
 
 template <typename T>
@@ -40,6 +59,10 @@ VectorDynamic GetParameterVD(const TaskSetNormal &taskset,
                              std::string parameterType) {
     return GetParameterVD<T>(taskset.tasks_, parameterType);
 }
+template <typename T, auto Task::*Member>
+VectorDynamic GetParameterVD(const TaskSetNormal &taskset) {
+    return GetParameterVD<T, Member>(taskset.tasks_);
+}
 
 void UpdateTaskSetExecutionTime(TaskSet &taskSet,
                                 const VectorDynamic &executionTimeVec,
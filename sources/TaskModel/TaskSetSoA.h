@@ -0,0 +1,63 @@
+#pragma once
+
+#include <Eigen/Core>
+
+#include "sources/TaskModel/TaskSetNormal.h"
+#include "sources/TaskModel/Tasks.h"
+
+namespace rt_num_opt {
+template <typename T>
+using AlignedVector = std::vector<T, Eigen::aligned_allocator<T>>;
+
+/**
+ * @brief Structure-of-arrays view of a TaskSet, used by the analysis kernels
+ * that stream over one parameter of all the tasks.
+ *
+ * The view owns a copy of the parameters, so it must be synchronized by
+ * Update() after tasks_ of the corresponding TaskSetNormal is modified;
+ * Update() reuses the allocated memory.
+ */
+struct TaskSetSoA {
+    AlignedVector<double> period;
+    AlignedVector<double> wcet;
+    AlignedVector<double> deadline;
+    std::vector<int> priority;
+    int N;
+
+    TaskSetSoA() : N(0) {}
+    TaskSetSoA(const TaskSet &tasks) { Update(tasks); }
+    TaskSetSoA(const TaskSetNormal &tasks) { Update(tasks.tasks_); }
+
+    void Update(const TaskSet &tasks) {
+        N = tasks.size();
+        period.resize(N);
+        wcet.resize(N);
+        deadline.resize(N);
+        priority.resize(N);
+        for (int i = 0; i < N; i++) Update(i, tasks[i]);
+    }
+    void Update(const TaskSetNormal &tasks) { Update(tasks.tasks_); }
+
+    inline void Update(int index, const Task &task) {
+        period[index] = task.period;
+        wcet[index] = task.executionTime;
+        deadline[index] = task.deadline;
+        priority[index] = task.priority;
+    }
+
+    // the same interface as TaskSetNormal::UpdateTaskSetParameter
+    void UpdateTaskSetParameter(int index, double value,
+                                std::string parameter = "executionTime") {
+        if (parameter == "executionTime") {
+            wcet.at(index) = value;
+        } else if (parameter == "period") {
+            period.at(index) = value;
+        } else {
+            CoutError("Please provide Update parameter for " + parameter);
+        }
+    }
+
+    size_t size() const { return N; }
+};
+
+}  // namespace rt_num_opt
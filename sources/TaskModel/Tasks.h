@@ -10,6 +10,7 @@
 
 #include "sources/MatrixConvenient.h"
 #include "sources/Tools/colormod.h"
+#include "sources/Utils/OptimizationContext.h"
 #include "sources/Utils/Parameters.h"
 
 namespace rt_num_opt {
@@ -146,39 +147,53 @@ void Print(const TaskSet &tasks) {
     for (auto &task : tasks) task.print();
 }
 
-template <typename T>
-VectorDynamic GetParameterVD(const TaskSet &taskset,
-                             std::string parameterType) {
+/**
+ * @brief compile-time version of GetParameterVD, e.g.,
+ * GetParameterVD<double, &Task::period>(tasks)
+ */
+template <typename T, auto Task::*Member>
+VectorDynamic GetParameterVD(const TaskSet &taskset) {
     uint N = taskset.size();
     VectorDynamic parameterList;
     parameterList.resize(N, 1);
-    parameterList.setZero();
-
-    for (uint i = 0; i < N; i++) {
-        if (parameterType == "period")
-            parameterList(i, 0) = ((T)(taskset[i].period));
-        else if (parameterType == "periodOrg")
-            parameterList(i, 0) = ((T)(taskset[i].periodOrg));
-        else if (parameterType == "executionTime")
-            parameterList(i, 0) = ((T)(taskset[i].executionTime));
-        else if (parameterType == "executionTimeOrg")
-            parameterList(i, 0) = ((T)(taskset[i].executionTimeOrg));
-        else if (parameterType == "overhead")
-            parameterList(i, 0) = ((T)(taskset[i].overhead));
-        else if (parameterType == "deadline")
-            parameterList(i, 0) = ((T)(taskset[i].deadline));
-        else if (parameterType == "offset")
-            parameterList(i, 0) = ((T)(taskset[i].offset));
-        else {
-            std::cout << Color::red
-                      << "parameterType in GetParameter is not recognized!\n"
-                      << Color::def << std::endl;
-            throw;
-        }
-    }
+    for (uint i = 0; i < N; i++)
+        parameterList(i, 0) = ((T)(taskset[i].*Member));
     return parameterList;
 }
 
+template <typename T, auto Task::*Member>
+std::vector<T> GetParameter(const TaskSet &taskset) {
+    std::vector<T> parameterList;
+    parameterList.reserve(taskset.size());
+    for (const Task &task : taskset) parameterList.push_back((T)(task.*Member));
+    return parameterList;
+}
+
+template <typename T>
+VectorDynamic GetParameterVD(const TaskSet &taskset,
+                             std::string parameterType) {
+    if (parameterType == "period")
+        return GetParameterVD<T, &Task::period>(taskset);
+    else if (parameterType == "periodOrg")
+        return GetParameterVD<T, &Task::periodOrg>(taskset);
+    else if (parameterType == "executionTime")
+        return GetParameterVD<T, &Task::executionTime>(taskset);
+    else if (parameterType == "executionTimeOrg")
+        return GetParameterVD<T, &Task::executionTimeOrg>(taskset);
+    else if (parameterType == "overhead")
+        return GetParameterVD<T, &Task::overhead>(taskset);
+    else if (parameterType == "deadline")
+        return GetParameterVD<T, &Task::deadline>(taskset);
+    else if (parameterType == "offset")
+        return GetParameterVD<T, &Task::offset>(taskset);
+    else {
+        std::cout << Color::red
+                  << "parameterType in GetParameter is not recognized!\n"
+                  << Color::def << std::endl;
+        throw;
+    }
+}
+
 template <typename T>
 std::vector<T> GetParameter(const TaskSet &taskset, std::string parameterType) {
     VectorDynamic resEigen = GetParameterVD<T>(taskset, parameterType);
@@ -197,13 +212,9 @@ static bool compareDeadline(const Task &task1, const Task &task2) {
 };
 
 double Utilization(const TaskSet &tasks) {
-    std::vector<int> periods = GetParameter<int>(tasks, "period");
-    std::vector<double> executionTimes =
-        GetParameter<double>(tasks, "executionTime");
-    int N = periods.size();
     double utilization = 0;
-    for (int i = 0; i < N; i++)
-        utilization += double(executionTimes[i]) / periods[i];
+    for (const Task &task : tasks)
+        utilization += double(task.executionTime) / int(task.period);
     return utilization;
 }
 
@@ -265,6 +276,7 @@ void ReadFrequencyModeRatio(std::string path) {
     std::fstream file;
     file.open(path, std::ios::in);
     if (file.is_open()) {
+        double &frequencyRatio = CurrentOptimizationContext().frequencyRatio;
         std::string line;
         while (getline(file, line)) {
             if (line.substr(0, 17) == "Frequency_Ratio: ") {
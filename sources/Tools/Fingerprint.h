@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+namespace rt_num_opt {
+/**
+ * @brief order-sensitive 64-bit hash of a sequence of numbers, e.g., the
+ * parameters of a task set; doubles are hashed by their bits
+ */
+class Fingerprint64 {
+   public:
+    Fingerprint64() : hash_(0x9e3779b97f4a7c15ULL) {}
+
+    Fingerprint64 &Add(uint64_t value) {
+        hash_ = Mix(hash_ ^ Mix(value + 0x9e3779b97f4a7c15ULL));
+        return *this;
+    }
+    Fingerprint64 &Add(double value) {
+        // +0.0 and -0.0 are the same parameter
+        if (value == 0)
+            value = 0;
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return Add(bits);
+    }
+    Fingerprint64 &Add(int value) { return Add(uint64_t(int64_t(value))); }
+    Fingerprint64 &Add(long long value) { return Add(uint64_t(value)); }
+
+    uint64_t Value() const { return hash_; }
+
+   private:
+    // the finalizer of splitmix64
+    static uint64_t Mix(uint64_t x) {
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    uint64_t hash_;
+};
+}  // namespace rt_num_opt
@@ -63,6 +63,20 @@ void EndTimer(std::string funcName, bool print = false) {
     }
 }
 
+// event counters, e.g., cache hits, printed together with the timers
+std::unordered_map<std::string, size_t> counterMap;
+
+void IncrementCounter(std::string name, size_t n = 1) {
+    std::lock_guard<std::mutex> lock(mtx_profiler);
+    counterMap[name] += n;
+}
+
+size_t ReadCounter(std::string name) {
+    std::lock_guard<std::mutex> lock(mtx_profiler);
+    auto itr = counterMap.find(name);
+    return itr == counterMap.end() ? 0 : itr->second;
+}
+
 struct TimerDataProfiler {
     std::string name;
     double accum;
@@ -92,4 +106,7 @@ void PrintTimer() {
     }
     std::cout << Color::green << "Total profiled portion: " << totalProfile - 1
               << Color::def << std::endl;
+    for (auto itr = counterMap.begin(); itr != counterMap.end(); itr++)
+        std::cout << Color::green << "Counter: " << itr->second
+                  << " Name: " << itr->first << Color::def << std::endl;
 }
\ No newline at end of file
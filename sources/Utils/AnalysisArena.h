@@ -0,0 +1,152 @@
+/**
+ * @file AnalysisArena.h
+ * @brief Process-lifetime TBB arena in which the schedulability analysis
+ * (NP::Global::State_space::explore) runs, so that its thread pool is not
+ * created and destroyed on every RTA call.
+ *
+ * The concurrency and the cores are read from Nasri19Param_threadNumber and
+ * Nasri19Param_cores, and can be changed by Configure, e.g., to keep the
+ * analysis on a few cores while the batch jobs use the others.
+ */
+#pragma once
+
+#include <pthread.h>
+#include <sched.h>
+#include <tbb/task_arena.h>
+#include <tbb/task_scheduler_observer.h>
+
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "sources/Tools/testMy.h"
+#include "sources/Utils/Parameters.h"
+
+namespace rt_num_opt {
+
+/**
+ * @brief parse a core list such as "0-3,6" into {0, 1, 2, 3, 6}; an empty
+ * string gives an empty list. Reversed ranges and cores that a cpu_set_t
+ * cannot hold are errors.
+ */
+inline std::vector<int> ParseCoreList(const std::string &str) {
+    std::vector<int> cores;
+    std::stringstream ss(str);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.find_first_not_of(" ") == std::string::npos)
+            continue;
+        size_t dash = item.find('-');
+        int first = 0, last = 0;
+        try {
+            first = std::stoi(item.substr(0, dash));
+            last = dash == std::string::npos ? first
+                                             : std::stoi(item.substr(dash + 1));
+        } catch (const std::exception &) {
+            CoutError("Invalid core list: " + str);
+        }
+        if (first < 0 || last < first || last >= CPU_SETSIZE)
+            CoutError("Invalid core list: " + str);
+        for (int core = first; core <= last; core++) cores.push_back(core);
+    }
+    return cores;
+}
+
+/**
+ * @brief pins every thread that enters the observed arena to the given cores;
+ * the threads of the caller get their previous affinity back when they leave
+ */
+class CorePinningObserver : public tbb::task_scheduler_observer {
+   public:
+    CorePinningObserver(tbb::task_arena &arena, const std::vector<int> &cores)
+        : tbb::task_scheduler_observer(arena) {
+        CPU_ZERO(&cpuSet_);
+        for (int core : cores) CPU_SET(core, &cpuSet_);
+        observe(true);
+    }
+    ~CorePinningObserver() { observe(false); }
+
+    void on_scheduler_entry(bool isWorker) override {
+        if (!isWorker) {
+            cpu_set_t previous;
+            pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t),
+                                   &previous);
+            PreviousAffinity().push_back(previous);
+        }
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t),
+                                   &cpuSet_) != 0)
+            CoutWarning("Failed to pin the analysis thread to its cores");
+    }
+
+    void on_scheduler_exit(bool isWorker) override {
+        if (isWorker || PreviousAffinity().empty())
+            return;
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t),
+                               &PreviousAffinity().back());
+        PreviousAffinity().pop_back();
+    }
+
+   private:
+    // a stack because the caller may enter the arena recursively
+    static std::vector<cpu_set_t> &PreviousAffinity() {
+        thread_local std::vector<cpu_set_t> previous;
+        return previous;
+    }
+
+    cpu_set_t cpuSet_;
+};
+
+class AnalysisArena {
+   public:
+    static AnalysisArena &Instance() {
+        static AnalysisArena arena;
+        return arena;
+    }
+
+    /**
+     * @brief recreate the arena; must not be called while an analysis is
+     * running
+     *
+     * @param threadNumber: maximal concurrency, 0 means all the cores (or all
+     * the given cores)
+     * @param cores: cores that the threads of the arena are pinned to, empty
+     * means no pinning
+     */
+    void Configure(int threadNumber, const std::vector<int> &cores) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        observer_.reset();
+        int concurrency = threadNumber;
+        if (concurrency <= 0)
+            concurrency = cores.empty() ? int(tbb::task_arena::automatic)
+                                        : int(cores.size());
+        arena_.reset(new tbb::task_arena(concurrency));
+        arena_->initialize();
+        if (!cores.empty())
+            observer_.reset(new CorePinningObserver(*arena_, cores));
+    }
+
+    int Concurrency() { return arena_->max_concurrency(); }
+
+    // run f in the arena and wait for it, including its parallel work
+    template <class Function>
+    void Execute(const Function &f) {
+        arena_->execute(f);
+    }
+
+   private:
+    AnalysisArena() {
+        Configure(Nasri19Param_threadNumber,
+                  ParseCoreList(Nasri19Param_cores));
+    }
+    AnalysisArena(const AnalysisArena &) = delete;
+    AnalysisArena &operator=(const AnalysisArena &) = delete;
+
+    std::mutex mtx_;
+    // declared before observer_, which must be destroyed first
+    std::unique_ptr<tbb::task_arena> arena_;
+    std::unique_ptr<CorePinningObserver> observer_;
+};
+
+}  // namespace rt_num_opt
@@ -3,21 +3,15 @@
 #include <gtsam/nonlinear/Values.h>
 
 #include "sources/MatrixConvenient.h"
+#include "sources/Utils/OptimizationContext.h"
 #include "sources/Utils/Parameters.h"
 #include "sources/TaskModel/Tasks.h"
 #include "sources/Tools/testMy.h"
 namespace rt_num_opt
 {
-    // these two variables record the best solution ever known yet
-    double valueGlobalOpt = INT64_MAX;
-    VectorDynamic vectorGlobalOpt;
-
     void InitializeGlobalVector(int N)
     {
-        vectorGlobalOpt.resize(N, 1);
-        vectorGlobalOpt.setZero();
-        valueGlobalOpt = INT64_MAX;
-        TASK_NUMBER = N;
+        CurrentOptimizationContext().InitializeGlobalVector(N);
     }
 
     enum class EliminationType
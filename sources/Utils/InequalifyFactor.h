@@ -21,6 +21,7 @@
 #include "sources/Tools/colormod.h"
 #include "sources/Tools/testMy.h"
 #include "sources/Utils/GlobalVariables.h"
+#include "sources/Utils/JacobianBatch.h"
 #include "sources/Utils/Parameters.h"
 #include "sources/Utils/utils.h"
 namespace rt_num_opt {
@@ -32,8 +33,6 @@ namespace rt_num_opt {
  */
 double HingeLoss(double x) { return max(0, -1 * x); }
 
-typedef boost::function<VectorDynamic(const VectorDynamic &)>
-    NormalErrorFunction1D;
 typedef boost::function<VectorDynamic(const VectorDynamic &,
                                       const VectorDynamic &)>
     NormalErrorFunction2D;
@@ -89,8 +88,8 @@ class InequalityFactor1D : public gtsam::NoiseModelFactor1<VectorDynamic> {
         VectorDynamic err = f(x);
         if (H) {
             if (exactJacobian) {
-                *H =
-                    NumericalDerivativeDynamic(f, x, deltaOptimizer, dimension);
+                *H = NumericalDerivativeDynamicBatch(f, x, deltaOptimizer,
+                                                     dimension);
             } else {
                 *H = GenerateVectorDynamic(dimension);
             }
@@ -0,0 +1,161 @@
+/**
+ * @file JacobianBatch.h
+ * @brief Numerical Jacobians whose perturbed points are built first and then
+ * evaluated together, either in parallel on TBB's thread pool or by a
+ * customized batch evaluator (e.g., RTA_LL_Batch). The finite-difference
+ * formula is the same as NumericalDerivativeDynamic.
+ *
+ * The error functions must be thread-safe if parallelJacobian is 1.
+ */
+#pragma once
+
+#include <gtsam/inference/Symbol.h>
+#include <gtsam/nonlinear/Values.h>
+#include <tbb/parallel_for.h>
+
+#include <boost/function.hpp>
+
+#include "sources/MatrixConvenient.h"
+#include "sources/Utils/OptimizationContext.h"
+#include "sources/Utils/Parameters.h"
+
+namespace rt_num_opt {
+typedef boost::function<VectorDynamic(const VectorDynamic &)>
+    NormalErrorFunction1D;
+typedef boost::function<gtsam::Vector(const gtsam::Values &x)> LambdaMultiKey;
+typedef boost::function<std::vector<VectorDynamic>(
+    const std::vector<gtsam::Values> &)>
+    LambdaMultiKeyBatch;
+
+/**
+ * @brief whether to evaluate the perturbations in parallel
+ *
+ * @param analysisType Schedul_Analysis::type() of the error function; Nasri19
+ * analyses are evaluated one at a time: their analysis is parallel already,
+ * and its time-out reads the CPU time of the whole process, which concurrent
+ * analyses would use up
+ */
+inline bool ParallelJacobian(const std::string &analysisType = "") {
+    return parallelJacobian && analysisType != "Nasri19";
+}
+
+/**
+ * @brief evaluate h on all the points, in parallel if parallel is true;
+ * the i-th result corresponds to the i-th point. The worker threads use the
+ * OptimizationContext of the calling thread.
+ */
+template <class Function, class Point>
+std::vector<VectorDynamic> EvaluateBatch(const Function &h,
+                                         const std::vector<Point> &points,
+                                         bool parallel = ParallelJacobian()) {
+    std::vector<VectorDynamic> res(points.size());
+    if (parallel) {
+        OptimizationContext &context = CurrentOptimizationContext();
+        tbb::parallel_for(size_t(0), points.size(), [&](size_t i) {
+            OptimizationContextScope scope(context);
+            res[i] = h(points[i]);
+        });
+    } else {
+        for (size_t i = 0; i < points.size(); i++) res[i] = h(points[i]);
+    }
+    return res;
+}
+
+inline LambdaMultiKeyBatch GenerateBatchEvaluator(
+    const LambdaMultiKey &f, bool parallel = ParallelJacobian()) {
+    return [f, parallel](const std::vector<gtsam::Values> &points) {
+        return EvaluateBatch(f, points, parallel);
+    };
+}
+
+/**
+ * @brief the same as NumericalDerivativeDynamic, but the 2n perturbed points
+ * are evaluated in one batch
+ */
+inline MatrixDynamic NumericalDerivativeDynamicBatch(
+    const NormalErrorFunction1D &h, const VectorDynamic &x,
+    double deltaOptimizer, int mOfJacobian = -1) {
+    BeginTimer(__func__);
+    int n = x.rows();
+    std::vector<VectorDynamic> points;
+    points.reserve(2 * n);
+    for (int i = 0; i < n; i++) {
+        VectorDynamic xDelta = x;
+        xDelta(i, 0) = xDelta(i, 0) + deltaOptimizer;
+        points.push_back(xDelta);
+        xDelta(i, 0) = xDelta(i, 0) - 2 * deltaOptimizer;
+        points.push_back(xDelta);
+    }
+    std::vector<VectorDynamic> res = EvaluateBatch(h, points);
+    if (mOfJacobian == -1)
+        mOfJacobian = n > 0 ? res[0].rows() : h(x).rows();
+
+    MatrixDynamic jacobian = GenerateMatrixDynamic(mOfJacobian, n);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < mOfJacobian; j++)
+            jacobian(j, i) =
+                (res[2 * i](j, 0) - res[2 * i + 1](j, 0)) / 2 / deltaOptimizer;
+    }
+    EndTimer(__func__);
+    return jacobian;
+}
+
+/**
+ * @brief Jacobians of f(x) with respect to every key in keyVec, all the
+ * perturbed gtsam::Values are evaluated in one batch by fBatch
+ *
+ * @param mOfJacobian: dimension of f(x)
+ * @param skipKey: skipKey[i] = true means perturbing keyVec[i] provably
+ * cannot change f(x), so its Jacobian is zero and it is not evaluated
+ */
+inline std::vector<gtsam::Matrix> NumericalDerivativeMultiKeyBatch(
+    const LambdaMultiKeyBatch &fBatch, const gtsam::Values &x,
+    const std::vector<gtsam::Symbol> &keyVec, double deltaOptimizer,
+    int mOfJacobian, const std::vector<bool> &skipKey = std::vector<bool>()) {
+    BeginTimer(__func__);
+    // (key index, dimension) of every perturbation
+    std::vector<std::pair<int, int>> perturbations;
+    std::vector<gtsam::Values> points;
+    for (uint i = 0; i < keyVec.size(); i++) {
+        if (i < skipKey.size() && skipKey[i])
+            continue;
+        const VectorDynamic &xi = x.at<VectorDynamic>(keyVec[i]);
+        for (int d = 0; d < xi.rows(); d++) {
+            perturbations.push_back(std::make_pair(i, d));
+            VectorDynamic xDelta = xi;
+            xDelta(d, 0) = xDelta(d, 0) + deltaOptimizer;
+            gtsam::Values xx = x;
+            xx.update(keyVec[i], xDelta);
+            points.push_back(xx);
+            xDelta(d, 0) = xDelta(d, 0) - 2 * deltaOptimizer;
+            xx.update(keyVec[i], xDelta);
+            points.push_back(xx);
+        }
+    }
+    std::vector<VectorDynamic> res = fBatch(points);
+
+    std::vector<gtsam::Matrix> jacobians(keyVec.size());
+    for (uint i = 0; i < keyVec.size(); i++)
+        jacobians[i] = GenerateMatrixDynamic(
+            mOfJacobian, x.at<VectorDynamic>(keyVec[i]).rows());
+    for (uint k = 0; k < perturbations.size(); k++) {
+        int i = perturbations[k].first;
+        int d = perturbations[k].second;
+        for (int j = 0; j < mOfJacobian; j++)
+            jacobians[i](j, d) =
+                (res[2 * k](j, 0) - res[2 * k + 1](j, 0)) / 2 / deltaOptimizer;
+    }
+    EndTimer(__func__);
+    return jacobians;
+}
+
+inline std::vector<gtsam::Matrix> NumericalDerivativeMultiKey(
+    const LambdaMultiKey &f, const gtsam::Values &x,
+    const std::vector<gtsam::Symbol> &keyVec, double deltaOptimizer,
+    int mOfJacobian, const std::vector<bool> &skipKey = std::vector<bool>()) {
+    return NumericalDerivativeMultiKeyBatch(GenerateBatchEvaluator(f), x,
+                                            keyVec, deltaOptimizer, mOfJacobian,
+                                            skipKey);
+}
+
+}  // namespace rt_num_opt
@@ -20,14 +20,10 @@
 
 #include "sources/Tools/colormod.h"
 #include "sources/Tools/testMy.h"
+#include "sources/Utils/JacobianBatch.h"
 #include "sources/Utils/Parameters.h"
 #include "sources/Utils/utils.h"
 namespace rt_num_opt {
-typedef Eigen::Matrix<double, Eigen::Dynamic, 1> VectorDynamic;
-typedef boost::function<VectorDynamic(const VectorDynamic &)>
-    NormalErrorFunction1D;
-typedef boost::function<gtsam::Vector(const gtsam::Values &x)> LambdaMultiKey;
-
 typedef long long int LLint;
 
 typedef std::vector<VectorDynamic> VVec;
@@ -52,16 +48,10 @@ class MultiKeyFactor : public gtsam::NoiseModelFactor {
                                   boost::optional<std::vector<gtsam::Matrix> &>
                                       H = boost::none) const override {
         BeginTimer("MultiKeyFactor");
+        gtsam::Vector err = lambdaMK(x);
         if (H) {
-            for (uint i = 0; i < dimension; i++) {
-                NormalErrorFunction1D f = [x, i, this](const VectorDynamic xi) {
-                    gtsam::Values xx = x;
-                    xx.update(keyVec.at(i), xi);
-                    return lambdaMK(xx);
-                };
-                (*H)[i] = NumericalDerivativeDynamic(
-                    f, x.at<VectorDynamic>(keyVec[i]), deltaOptimizer);
-            }
+            *H = NumericalDerivativeMultiKey(lambdaMK, x, keyVec,
+                                             deltaOptimizer, err.rows());
             if (debugMode == 1) {
                 std::lock_guard<std::mutex> lock(mtx);
                 std::cout << Color::blue;
@@ -69,7 +59,7 @@ class MultiKeyFactor : public gtsam::NoiseModelFactor {
             }
         }
         EndTimer("MultiKeyFactor");
-        return lambdaMK(x);
+        return err;
     }
 };
 
@@ -0,0 +1,180 @@
+/**
+ * @file OptimizationContext.h
+ * @brief State of one optimization run: the tunables that the optimizers
+ * modify while running, the RTA counters, and the best solution known so far.
+ *
+ * Each thread works on its current context, which is the default context
+ * unless an OptimizationContextScope installs another one. Energy_Opt,
+ * Energy_OptDAG and ControlOptimize install the context they are given, so
+ * the RTA classes and factors constructed during the optimization use it;
+ * several task sets can therefore be optimized concurrently in one process as
+ * long as each of them has its own context.
+ *
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+#include "sources/MatrixConvenient.h"
+#include "sources/Utils/Parameters.h"
+
+namespace rt_num_opt {
+struct OptimizationContext {
+    // initialized from parameters.yaml, reduced during control optimization
+    double relativeErrorTolerance;
+    // parameter of the execution time model, read with the task set
+    double frequencyRatio;
+    int taskNumber;
+
+    std::atomic<size_t> rtaCallingTimes;
+    std::atomic<size_t> rtaControl;
+
+    // these two variables record the best solution ever known yet
+    double valueGlobalOpt;
+    VectorDynamic vectorGlobalOpt;
+
+    // the optimizers stop their outer loops after the deadline
+    std::chrono::steady_clock::time_point deadline;
+
+    OptimizationContext()
+        : relativeErrorTolerance(rt_num_opt::relativeErrorTolerance),
+          frequencyRatio(0),
+          taskNumber(0),
+          rtaCallingTimes(0),
+          rtaControl(0),
+          valueGlobalOpt(INT64_MAX),
+          deadline(std::chrono::steady_clock::time_point::max()) {}
+    OptimizationContext(const OptimizationContext &) = delete;
+    OptimizationContext &operator=(const OptimizationContext &) = delete;
+
+    void InitializeGlobalVector(int N) {
+        std::lock_guard<std::mutex> lock(mtxGlobalOpt_);
+        vectorGlobalOpt.resize(N, 1);
+        vectorGlobalOpt.setZero();
+        valueGlobalOpt = INT64_MAX;
+        taskNumber = N;
+    }
+
+    /**
+     * @brief record (value, vec) if it is better than the best solution known
+     * yet; factors may call it concurrently
+     */
+    void UpdateGlobalOpt(double value, const VectorDynamic &vec) {
+        std::lock_guard<std::mutex> lock(mtxGlobalOpt_);
+        if (value < valueGlobalOpt) {
+            vectorGlobalOpt = vec;
+            valueGlobalOpt = value;
+        }
+    }
+
+    void ResetCallingTimes() {
+        rtaCallingTimes = 0;
+        rtaControl = 0;
+    }
+
+    // seconds from now; non-positive values mean no limit
+    void SetTimeLimit(double seconds) {
+        if (seconds > 0)
+            deadline = std::chrono::steady_clock::now() +
+                       std::chrono::duration_cast<
+                           std::chrono::steady_clock::duration>(
+                           std::chrono::duration<double>(seconds));
+        else
+            deadline = std::chrono::steady_clock::time_point::max();
+    }
+    bool TimeOut() const {
+        return deadline != std::chrono::steady_clock::time_point::max() &&
+               std::chrono::steady_clock::now() >= deadline;
+    }
+
+   private:
+    std::mutex mtxGlobalOpt_;
+};
+
+inline OptimizationContext &DefaultOptimizationContext() {
+    static OptimizationContext context;
+    return context;
+}
+
+thread_local OptimizationContext *currentOptimizationContext = nullptr;
+
+inline OptimizationContext &CurrentOptimizationContext() {
+    if (currentOptimizationContext == nullptr)
+        return DefaultOptimizationContext();
+    return *currentOptimizationContext;
+}
+
+/**
+ * @brief make context the current context of this thread until the scope
+ * ends; scopes can be nested
+ */
+class OptimizationContextScope {
+   public:
+    explicit OptimizationContextScope(OptimizationContext &context)
+        : prev_(currentOptimizationContext) {
+        currentOptimizationContext = &context;
+    }
+    ~OptimizationContextScope() { currentOptimizationContext = prev_; }
+    OptimizationContextScope(const OptimizationContextScope &) = delete;
+    OptimizationContextScope &operator=(const OptimizationContextScope &) =
+        delete;
+
+   private:
+    OptimizationContext *prev_;
+};
+
+/**
+ * @brief while a scope is active, the RTA calls of this thread are counted in
+ * calls instead of the current context; SpeculativeBisection adds them to the
+ * context only for the probes that the serial search would have made
+ */
+thread_local size_t *currentProbeRTACalls = nullptr;
+
+class ProbeRTACallScope {
+   public:
+    explicit ProbeRTACallScope(size_t &calls) : prev_(currentProbeRTACalls) {
+        currentProbeRTACalls = &calls;
+    }
+    ~ProbeRTACallScope() { currentProbeRTACalls = prev_; }
+    ProbeRTACallScope(const ProbeRTACallScope &) = delete;
+    ProbeRTACallScope &operator=(const ProbeRTACallScope &) = delete;
+
+   private:
+    size_t *prev_;
+};
+
+/**
+ * @brief while a scope is active, the rtaControl increments of this thread
+ * are also counted in calls, e.g., to replay them on a SchedulabilityCache
+ * hit; an enclosing scope counts them, too, once the inner one ends
+ */
+thread_local size_t *currentRTAControlCalls = nullptr;
+
+class RTAControlScope {
+   public:
+    explicit RTAControlScope(size_t &calls)
+        : calls_(calls), prev_(currentRTAControlCalls) {
+        currentRTAControlCalls = &calls;
+    }
+    ~RTAControlScope() {
+        currentRTAControlCalls = prev_;
+        if (prev_ != nullptr)
+            *prev_ += calls_;
+    }
+    RTAControlScope(const RTAControlScope &) = delete;
+    RTAControlScope &operator=(const RTAControlScope &) = delete;
+
+   private:
+    size_t &calls_;
+    size_t *prev_;
+};
+
+// the fields of the default context under their old global names, used by
+// single-threaded callers such as the tests
+int &TASK_NUMBER = DefaultOptimizationContext().taskNumber;
+double &frequencyRatio = DefaultOptimizationContext().frequencyRatio;
+double &valueGlobalOpt = DefaultOptimizationContext().valueGlobalOpt;
+VectorDynamic &vectorGlobalOpt = DefaultOptimizationContext().vectorGlobalOpt;
+}  // namespace rt_num_opt
@@ -16,7 +16,6 @@ YAML::Node loaded_doc =
 
 double MaxLoopControl = loaded_doc["MaxLoopControl"].as<double>();
 int enableReorder = loaded_doc["enableReorder"].as<int>();
-int TASK_NUMBER = 0;
 double weightEnergy = loaded_doc["weightEnergy"].as<double>();
 
 double punishmentInBarrier = loaded_doc["punishmentInBarrier"].as<double>();
@@ -42,6 +41,8 @@ int executionTimeModel = loaded_doc["executionTimeModel"].as<int>();
 int enableMaxComputationTimeRestrict =
     loaded_doc["enableMaxComputationTimeRestrict"].as<int>();
 int exactJacobian = loaded_doc["exactJacobian"].as<int>();
+int parallelJacobian = loaded_doc["parallelJacobian"].as<int>();
+int schedulabilityCacheSize = loaded_doc["schedulabilityCacheSize"].as<int>();
 const int temperatureSA = loaded_doc["temperatureSA"].as<int>();
 double deltaOptimizer = loaded_doc["deltaOptimizer"].as<double>();
 const double initialLambda = loaded_doc["initialLambda"].as<double>();
@@ -82,6 +83,8 @@ std::string controlPath = loaded_doc["controlPath"].as<std::string>();
 std::string runMode = loaded_doc["runMode"].as<std::string>();
 std::string batchOptimizeFolder =
     loaded_doc["batchOptimizeFolder"].as<std::string>();
+int batchThreadNumber = loaded_doc["batchThreadNumber"].as<int>();
+double batchJobTimeLimit = loaded_doc["batchJobTimeLimit"].as<double>();
 const double parallelFactor = loaded_doc["parallelFactor"].as<double>();
 const std::string readTaskMode = loaded_doc["readTaskMode"].as<std::string>();
 const int debugMode = loaded_doc["debugMode"].as<int>();
@@ -105,7 +108,6 @@ int maxNode_GenerateTaskSet = loaded_doc["maxNode_GenerateTaskSet"].as<int>();
 int printRTA = loaded_doc["printRTA"].as<int>();
 const double relErrorTolIPM = loaded_doc["relErrorTolIPM"].as<double>();
 const double eliminateStep = loaded_doc["eliminateStep"].as<double>();
-double frequencyRatio = 0;
 double timeScaleFactor = loaded_doc["timeScaleFactor"].as<double>();
 double PeriodRoundQuantum = loaded_doc["PeriodRoundQuantum"].as<double>();
 double jacobianScale = loaded_doc["jacobianScale"].as<double>();
@@ -120,6 +122,18 @@ double OverallTimeLimit = loaded_doc["OverallTimeLimit"].as<double>();
 double Nasri19Param_timeout = loaded_doc["Nasri19Param_timeout"].as<double>();
 double Nasri19Param_max_depth =
     loaded_doc["Nasri19Param_max_depth"].as<double>();
+int Nasri19Param_threadNumber =
+    loaded_doc["Nasri19Param_threadNumber"].as<int>();
+std::string Nasri19Param_cores =
+    loaded_doc["Nasri19Param_cores"].as<std::string>();
+double Nasri19Param_memoryBudget =
+    loaded_doc["Nasri19Param_memoryBudget"].as<double>();
+int Nasri19Param_symmetryReduction =
+    loaded_doc["Nasri19Param_symmetryReduction"].as<int>();
+int Nasri19Param_idleWindows =
+    loaded_doc["Nasri19Param_idleWindows"].as<int>();
+int Nasri19Param_incremental =
+    loaded_doc["Nasri19Param_incremental"].as<int>();
 
 double Priority_assignment_threshold_incremental =
     loaded_doc["Priority_assignment_threshold_incremental"].as<double>();
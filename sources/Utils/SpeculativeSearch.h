@@ -0,0 +1,119 @@
+/**
+ * @file SpeculativeSearch.h
+ * @brief Bisection whose next few levels are evaluated in parallel. All the
+ * midpoints that the serial bisection may probe in the next `depth` steps are
+ * checked at once, and then the serial path is followed through the results;
+ * the returned value is therefore the same as the serial bisection even if
+ * the predicate is not monotone (e.g., Nasri19's analysis). So is the number
+ * of RTA calls in the OptimizationContext: the calls of the other probes are
+ * only counted in the profiler.
+ */
+#pragma once
+
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "sources/Tools/profilier.h"
+#include "sources/Utils/OptimizationContext.h"
+#include "sources/Utils/Parameters.h"
+
+namespace rt_num_opt {
+
+/**
+ * @brief number of bisection levels to evaluate at once, 2^depth - 1 probes
+ * keep all the threads of the current arena busy; debugMode = 1 runs serially
+ * because the probes print
+ */
+inline int SpeculationDepth() {
+    if (debugMode == 1)
+        return 1;
+    int concurrency = tbb::this_task_arena::max_concurrency();
+    int depth = 1;
+    while (depth < 6 && (1 << (depth + 1)) - 1 <= concurrency) depth++;
+    return depth;
+}
+
+/**
+ * @brief the same result as the serial bisection for the largest feasible
+ * value in [left, right]:
+ *     while (left < right) {
+ *         int mid = ceil((left + right) / 2.0);
+ *         if (feasible(mid)) left = mid; else right = mid - 1;
+ *     }
+ *
+ * @param feasible bool(int), called concurrently with the OptimizationContext
+ * of the caller
+ */
+template <class Feasible>
+int SpeculativeBisection(int left, int right, const Feasible &feasible,
+                         int depth = SpeculationDepth()) {
+    depth = std::max(depth, 1);
+    // node i of the bisection tree has the children 2i+1 (feasible) and 2i+2
+    int treeSize = (1 << depth) - 1;
+    std::vector<int> nodeLeft(treeSize), nodeRight(treeSize), nodeMid(treeSize);
+    std::vector<char> nodeFeasible(treeSize);
+    std::vector<size_t> nodeCalls(treeSize);
+    std::vector<int> probes;
+    OptimizationContext &context = CurrentOptimizationContext();
+    while (left < right) {
+        probes.clear();
+        nodeLeft[0] = left;
+        nodeRight[0] = right;
+        for (int i = 0; i < treeSize; i++) {
+            bool bisect = nodeLeft[i] < nodeRight[i];
+            if (bisect) {
+                nodeMid[i] = ceil((nodeLeft[i] + nodeRight[i]) / 2.0);
+                probes.push_back(i);
+            }
+            if (2 * i + 2 >= treeSize)
+                continue;
+            if (!bisect) {
+                // the serial bisection never reaches the subtree
+                nodeLeft[2 * i + 1] = nodeRight[2 * i + 1] = 0;
+                nodeLeft[2 * i + 2] = nodeRight[2 * i + 2] = 0;
+            } else {
+                nodeLeft[2 * i + 1] = nodeMid[i];
+                nodeRight[2 * i + 1] = nodeRight[i];
+                nodeLeft[2 * i + 2] = nodeLeft[i];
+                nodeRight[2 * i + 2] = nodeMid[i] - 1;
+            }
+        }
+        bool speculate = probes.size() > 1;
+        if (!speculate) {
+            nodeFeasible[0] = feasible(nodeMid[0]);
+        } else {
+            tbb::parallel_for(size_t(0), probes.size(), [&](size_t k) {
+                OptimizationContextScope scope(context);
+                nodeCalls[probes[k]] = 0;
+                ProbeRTACallScope calls(nodeCalls[probes[k]]);
+                nodeFeasible[probes[k]] = feasible(nodeMid[probes[k]]);
+            });
+        }
+        // follow the path of the serial bisection
+        size_t pathCalls = 0;
+        for (int i = 0; i < treeSize && left < right;) {
+            pathCalls += nodeCalls[i];
+            if (nodeFeasible[i]) {
+                left = nodeMid[i];
+                i = 2 * i + 1;
+            } else {
+                right = nodeMid[i] - 1;
+                i = 2 * i + 2;
+            }
+        }
+        if (speculate) {
+            size_t calls = 0;
+            for (int i : probes) calls += nodeCalls[i];
+            context.rtaCallingTimes += pathCalls;
+            IncrementCounter("SpeculativeBisection off-path RTA calls",
+                             calls - pathCalls);
+        }
+    }
+    return left;
+}
+
+}  // namespace rt_num_opt
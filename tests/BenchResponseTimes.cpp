@@ -0,0 +1,69 @@
+// Compares the finish-time bookkeeping of Nasri19's global analysis: the
+// original per-thread hash maps against the flat atomic array, on the DAG task
+// sets of TaskData/DAG_Energy_Opt/N*. Both must give the same results.
+#include "sources/BatchTestutils.h"
+#include "sources/RTA/RTA_Nasri19.h"
+#include "sources/Tools/profilier.h"
+using namespace rt_num_opt;
+
+template <class Space>
+Space ExploreTimed(const NP::Scheduling_problem<dtime_t> &problem,
+                   const NP::Analysis_options &opts, const std::string &name) {
+    BeginTimer(name);
+    Space space = Space::explore(problem, opts);
+    EndTimer(name);
+    return space;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2 || argc > 3) {
+        CoutError("Usage: BenchResponseTimes N [repeats]");
+        return 1;
+    }
+    char *pEnd;
+    int N = strtol(argv[1], &pEnd, 10);
+    int repeats = argc == 3 ? strtol(argv[2], &pEnd, 10) : 5;
+    std::string pathDataset =
+        "/home/zephyr/Programming/Energy_Opt_NLP/TaskData/DAG_Energy_Opt/N" +
+        std::to_string(N) + "/";
+    std::cout << "Directory: " << pathDataset << "\n";
+
+    BeginTimer("main");
+    typedef NP::Global::State_space<
+        dtime_t, NP::Global::Hashed_response_times<dtime_t>>
+        HashedSpace;
+    typedef NP::Global::State_space<dtime_t> AtomicSpace;
+    int taskSets = 0;
+    for (const auto &file : ReadFilesInDirectory(pathDataset.c_str())) {
+        if (file.size() < 5 || file.substr(file.size() - 5) != ".yaml")
+            continue;
+        DAG_Nasri19 dag_tasks = ReadDAGNasri19_Tasks(pathDataset + file);
+        if (dag_tasks.IsHyperPeriodOverflow() ||
+            dag_tasks.GetTotalJobsWithinHyperPeriod() > Job_Limit_Scheduling)
+            continue;
+        PooledNasri19Problem builder;
+        const NP::Scheduling_problem<dtime_t> &problem = builder->Build(
+            dag_tasks, static_cast<unsigned int>(core_m_dag));
+        NP::Analysis_options opts = RTA_Nasri19(dag_tasks).AnalysisOptions(
+            problem, Nasri19Param_timeout);
+
+        for (int i = 0; i < repeats; i++) {
+            auto hashed = ExploreTimed<HashedSpace>(problem, opts,
+                                                    "Hashed_response_times");
+            auto atomic = ExploreTimed<AtomicSpace>(problem, opts,
+                                                    "Atomic_response_times");
+            bool same = hashed.is_schedulable() == atomic.is_schedulable() &&
+                        hashed.number_of_states() == atomic.number_of_states();
+            for (const auto &j : problem.jobs)
+                same = same && hashed.get_finish_times(j) ==
+                                   atomic.get_finish_times(j);
+            if (!same)
+                CoutError("Different results for " + file);
+        }
+        taskSets++;
+    }
+    std::cout << "Task sets: " << taskSets << ", repeats: " << repeats
+              << "\n";
+    EndTimer("main");
+    PrintTimer();
+}
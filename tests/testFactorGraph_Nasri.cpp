@@ -298,6 +298,45 @@ TEST(ControlObjFactor, Obj_Pow_v1) {
     EXPECT_DOUBLES_EQUAL(10 + 2 * 100 * 3, gra_exp, 1e-6);
 }
 
+TEST(ControlObjFactor, parallelJacobian) {
+    Period_Round_For_Control_Opt = 0;
+    core_m_dag = 4;
+    PeriodRoundQuantum = 1e3;
+    Obj_Pow = 1;
+    exactJacobian = 1;
+    std::string path =
+        "/home/zephyr/Programming/Energy_Opt_NLP/TaskData/"
+        "test_n3_v19.yaml";
+
+    rt_num_opt::DAG_Nasri19 tasks_dag = rt_num_opt::ReadDAGNasri19_Tasks(path);
+    VectorDynamic coeff = GenerateVectorDynamic(4 * 3);
+    coeff.setOnes();
+    std::vector<bool> maskForElimination(tasks_dag.SizeDag(), false);
+    FactorGraphNasri<DAG_Nasri19,
+                     RTA_Nasri19>::ControlObjFactor control_obj_factor =
+        FactorGraphNasri<DAG_Nasri19, RTA_Nasri19>::GenerateControlObjFactor(
+            maskForElimination, coeff, tasks_dag);
+    gtsam::Values initial_estimate =
+        FactorGraphNasri<DAG_Nasri19, RTA_Nasri19>::GenerateInitialFG(
+            tasks_dag, maskForElimination);
+
+    // Nasri19's time-out reads the CPU time of the whole process
+    parallelJacobian = 1;
+    EXPECT(!ParallelJacobian(RTA_Nasri19::type()));
+    EXPECT(ParallelJacobian("LL"));
+    std::vector<gtsam::Matrix> H_parallel(2, GenerateMatrixDynamic(1, 1));
+    control_obj_factor.unwhitenedError(initial_estimate, H_parallel);
+
+    parallelJacobian = 0;
+    EXPECT(!ParallelJacobian("LL"));
+    std::vector<gtsam::Matrix> H_serial(2, GenerateMatrixDynamic(1, 1));
+    control_obj_factor.unwhitenedError(initial_estimate, H_serial);
+    for (uint i = 0; i < H_serial.size(); i++)
+        EXPECT(gtsam::assert_equal(H_serial[i], H_parallel[i], 1e-9));
+    parallelJacobian = 1;
+    exactJacobian = 0;
+}
+
 int main() {
     TestResult tr;
     return TestRegistry::runAllTests(tr);
@@ -3,6 +3,7 @@
 #include <gtsam/base/Testable.h>
 #include <yaml-cpp/yaml.h>
 
+#include "sources/BatchRunner.h"
 #include "sources/ControlOptimization/AdjustPriority.h"
 #include "sources/ControlOptimization/FactorGraph_Nasri19.h"
 #include "sources/MatrixConvenient.h"
@@ -130,6 +131,79 @@ TEST(rta, Nasri_no_edge) {
     AssertEigenEqualVector(rtaExpect, rta);
 }
 
+TEST(rta, Nasri_schedulability_only) {
+    rt_num_opt::PeriodRoundQuantum = 1;
+    rt_num_opt::Period_Round_For_Control_Opt = 0;
+    std::string path =
+        "/home/zephyr/Programming/Energy_Opt_NLP/TaskData/taskset.yaml";
+    std::vector<rt_num_opt::DAG_Model> dags =
+        rt_num_opt::ReadDAG_NasriFromYaml(path);
+    for (int cores : {1, 2, 3}) {
+        rt_num_opt::core_m_dag = cores;
+        rt_num_opt::DAG_Nasri19 dagNasri(dags);
+        SchedulabilityCache::Instance().Clear();
+        rt_num_opt::RTA_Nasri19 r(dagNasri);
+        bool schedulable = r.CheckSchedulability();
+        SchedulabilityCache::Instance().Clear();
+        EXPECT(schedulable ==
+               r.CheckSchedulabilityDirect(r.ResponseTimeOfTaskSet()));
+        EXPECT(schedulable == (cores > 1));
+    }
+}
+
+TEST(rta, Nasri_incremental) {
+    rt_num_opt::PeriodRoundQuantum = 1;
+    rt_num_opt::core_m_dag = 3;
+    std::string path =
+        "/home/zephyr/Programming/Energy_Opt_NLP/TaskData/taskset.yaml";
+    rt_num_opt::DAG_Nasri19 dagNasri(rt_num_opt::ReadDAG_NasriFromYaml(path));
+    // the second job of the second DAG disappears
+    rt_num_opt::DAG_Nasri19 dagLonger = dagNasri;
+    dagLonger.UpdatePeriod(1, 60);
+    SchedulabilityCache::Instance().Clear();
+    VectorDynamic rtaExpect = GetNasri19RTA(dagLonger);
+
+    // the results of the other setting are not reused
+    int incremental = rt_num_opt::Nasri19Param_incremental;
+    rt_num_opt::Nasri19Param_incremental = 16;
+    GetNasri19RTA(dagNasri);
+    AssertEigenEqualVector(rtaExpect, GetNasri19RTA(dagLonger));
+    SchedulabilityCache::Instance().Clear();
+    EXPECT(CheckNasri19Schedulability(dagNasri) ==
+           RTA_Nasri19(dagNasri).CheckSchedulabilityDirect(
+               GetNasri19RTA(dagNasri)));
+    rt_num_opt::Nasri19Param_incremental = incremental;
+}
+
+TEST(SchedulabilityCache, Nasri19) {
+    rt_num_opt::PeriodRoundQuantum = 1;
+    rt_num_opt::core_m_dag = 3;
+    std::string path =
+        "/home/zephyr/Programming/Energy_Opt_NLP/TaskData/taskset.yaml";
+    rt_num_opt::DAG_Nasri19 dagNasri(rt_num_opt::ReadDAG_NasriFromYaml(path));
+    SchedulabilityCache &cache = SchedulabilityCache::Instance();
+    cache.Clear();
+    VectorDynamic rtaExpect = GetNasri19RTA(dagNasri);
+    CHECK_EQUAL(1u, cache.ReadSize());
+
+    // every option of the exploration is part of the key
+    int symmetry = rt_num_opt::Nasri19Param_symmetryReduction;
+    rt_num_opt::Nasri19Param_symmetryReduction = 1 - symmetry;
+    AssertEigenEqualVector(rtaExpect, GetNasri19RTA(dagNasri));
+    CHECK_EQUAL(2u, cache.ReadSize());
+    rt_num_opt::Nasri19Param_symmetryReduction = symmetry;
+
+    // an exploration out of memory is unschedulable, but not remembered
+    double budget = rt_num_opt::Nasri19Param_memoryBudget;
+    rt_num_opt::Nasri19Param_memoryBudget = 1e-6;
+    EXPECT(!CheckNasri19Schedulability(dagNasri));
+    EXPECT(!RTA_Nasri19(dagNasri).CheckSchedulabilityDirect(
+        GetNasri19RTA(dagNasri)));
+    CHECK_EQUAL(2u, cache.ReadSize());
+    rt_num_opt::Nasri19Param_memoryBudget = budget;
+    AssertEigenEqualVector(rtaExpect, GetNasri19RTA(dagNasri));
+}
+
 TEST(rta, Sync) {
     rt_num_opt::PeriodRoundQuantum = 1;
     rt_num_opt::core_m_dag = 3;
@@ -152,6 +226,108 @@ TEST(rta, Sync) {
     std::cout << rta << std::endl;
 }
 
+TEST(Nasri19Problem, same_as_csv) {
+    rt_num_opt::PeriodRoundQuantum = 1;
+    std::string path =
+        "/home/zephyr/Programming/Energy_Opt_NLP/TaskData/taskset.yaml";
+    std::vector<rt_num_opt::DAG_Model> dags =
+        rt_num_opt::ReadDAG_NasriFromYaml(path);
+    rt_num_opt::DAG_Nasri19 dagNasri(dags);
+    Nasri19Problem builder;
+    for (int ite = 0; ite < 2; ite++) {
+        // the second build only rewrites the changed jobs
+        dagNasri.tasks_[0].executionTime += ite;
+        std::stringstream tasksInput;
+        tasksInput << dagNasri.ConvertTasksetToCsv();
+        std::stringstream dagInput;
+        dagInput << dagNasri.convertDAGsToCsv();
+        NP::Job<dtime_t>::Job_set jobsExpect =
+            NP::parse_file<dtime_t>(tasksInput);
+        NP::Precedence_constraints dagExpect = NP::parse_dag_file(dagInput);
+
+        const NP::Scheduling_problem<dtime_t> &problem =
+            builder.Build(dagNasri, 3);
+        CHECK_EQUAL(jobsExpect.size(), problem.jobs.size());
+        for (size_t i = 0; i < jobsExpect.size(); i++) {
+            const NP::Job<dtime_t> &job = problem.jobs[i];
+            EXPECT(jobsExpect[i].get_id() == job.get_id());
+            EXPECT(jobsExpect[i].arrival_window() == job.arrival_window());
+            EXPECT(jobsExpect[i].get_cost() == job.get_cost());
+            CHECK_EQUAL(jobsExpect[i].get_deadline(), job.get_deadline());
+            CHECK_EQUAL(jobsExpect[i].get_priority(), job.get_priority());
+            CHECK_EQUAL(jobsExpect[i].get_key(), job.get_key());
+        }
+        CHECK_EQUAL(dagExpect.size(), problem.dag.size());
+        for (size_t i = 0; i < dagExpect.size(); i++)
+            EXPECT(dagExpect[i] == problem.dag[i]);
+        CHECK_EQUAL(3u, problem.num_processors);
+    }
+}
+
+TEST(Nasri19Problem, idle_windows) {
+    typedef NP::Scheduling_problem<dtime_t> Problem;
+    auto job = [](unsigned long id, dtime_t r1, dtime_t r2, dtime_t c,
+                  dtime_t deadline, unsigned long task) {
+        return NP::Job<dtime_t>{id, Interval<dtime_t>{r1, r2},
+                                Interval<dtime_t>{1, c}, deadline, deadline,
+                                task};
+    };
+    Problem::Workload jobs{job(0, 0, 0, 4, 10, 0), job(1, 0, 2, 4, 10, 1),
+                           job(2, 10, 10, 4, 20, 0), job(3, 10, 10, 4, 20, 1),
+                           job(4, 12, 12, 4, 20, 2)};
+    // on one core, the first two jobs finish by 2 + 4 + 4
+    Problem problem(jobs, 1);
+    std::vector<Problem> windows = SplitAtIdleInstants(problem);
+    EXPECT_LONGS_EQUAL(2, windows.size());
+    EXPECT_LONGS_EQUAL(2, windows[0].jobs.size());
+    EXPECT_LONGS_EQUAL(3, windows[1].jobs.size());
+    auto space = NP::Global::State_space<dtime_t>::explore(problem.jobs, 1);
+    for (const Problem &w : windows) {
+        auto part = NP::Global::State_space<dtime_t>::explore(w.jobs, 1);
+        for (const auto &j : w.jobs)
+            EXPECT(part.get_finish_times(j) == space.get_finish_times(j));
+    }
+
+    // the constraint to the next window always holds
+    Problem chained(jobs, {{NP::JobID(0, 0), NP::JobID(2, 0)}}, 1);
+    windows = SplitAtIdleInstants(chained);
+    EXPECT_LONGS_EQUAL(2, windows.size());
+    EXPECT_LONGS_EQUAL(0, windows[1].dag.size());
+    // but not one from a later job
+    Problem reversed(jobs, {{NP::JobID(2, 0), NP::JobID(1, 1)}}, 1);
+    EXPECT_LONGS_EQUAL(1, SplitAtIdleInstants(reversed).size());
+    // nor is the system idle at 10 after a longer job
+    jobs[1] = job(1, 0, 2, 5, 10, 1);
+    EXPECT_LONGS_EQUAL(1, SplitAtIdleInstants(Problem(jobs, 1)).size());
+}
+
+TEST(AnalysisArena, pinned) {
+    std::vector<int> coresExpect = {0, 1, 2, 3, 6};
+    AssertEqualVectorExact(coresExpect, ParseCoreList("0-3, 6"));
+    CHECK_EQUAL(0u, ParseCoreList("").size());
+
+    rt_num_opt::core_m_dag = 3;
+    rt_num_opt::PeriodRoundQuantum = 1;
+    std::string path =
+        "/home/zephyr/Programming/Energy_Opt_NLP/TaskData/taskset.yaml";
+    rt_num_opt::DAG_Nasri19 dagNasri(rt_num_opt::ReadDAG_NasriFromYaml(path));
+    VectorDynamic rtaExpect = GetNasri19RTA(dagNasri);
+    cpu_set_t before, inside, after;
+    pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &before);
+    AnalysisArena::Instance().Configure(2, {0});
+    CHECK_EQUAL(2, AnalysisArena::Instance().Concurrency());
+    AnalysisArena::Instance().Execute([&]() {
+        pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &inside);
+    });
+    CHECK_EQUAL(1, CPU_COUNT(&inside));
+    CHECK(CPU_ISSET(0, &inside));
+    // the caller gets its own cores back
+    pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &after);
+    CHECK(CPU_EQUAL(&before, &after));
+    AssertEigenEqualVector(rtaExpect, GetNasri19RTA(dagNasri));
+    AnalysisArena::Instance().Configure(0, {});
+}
+
 TEST(read_dag, rounding) {
     rt_num_opt::PeriodRoundQuantum = 1;
     std::string path =
@@ -175,6 +351,46 @@ TEST(DAG, Adjust_period) {
     tasks_dag.AdjustPeriod(1, -2400);
     EXPECT_LONGS_EQUAL(1, tasks_dag.tasks_[2].period);
 }
+TEST(DAG, job_ids) {
+    rt_num_opt::PeriodRoundQuantum = 1000;
+    std::string path =
+        "/home/zephyr/Programming/Energy_Opt_NLP/TaskData/test_n3_v18.yaml";
+    rt_num_opt::DAG_Nasri19 tasks_dag = rt_num_opt::ReadDAGNasri19_Tasks(path);
+    for (int ite = 0; ite < 2; ite++) {
+        // the ids follow the order of ConvertTasksetToCsv
+        size_t globalId = 0, nodeIndex = 0;
+        for (size_t taskId = 0; taskId < tasks_dag.SizeDag(); taskId++) {
+            const DAG_Model &dag = tasks_dag.getDag(taskId);
+            for (size_t jobId = 0; jobId < dag.tasks_.size(); jobId++) {
+                EXPECT_LONGS_EQUAL(nodeIndex++,
+                                   tasks_dag.IdJobTaskLevel(taskId, jobId));
+                size_t count = tasks_dag.hyperPeriod / dag.tasks_[jobId].period;
+                for (size_t index = 0; index < count; index++) {
+                    EXPECT_LONGS_EQUAL(
+                        globalId, tasks_dag.IdJob2Global(taskId, jobId, index));
+                    auto ids = tasks_dag.IdsGlobal2Job(globalId++);
+                    EXPECT_LONGS_EQUAL(taskId, ids.taskId);
+                    EXPECT_LONGS_EQUAL(jobId, ids.jobId);
+                    EXPECT_LONGS_EQUAL(index, ids.instanceId);
+                }
+            }
+        }
+        EXPECT_LONGS_EQUAL(tasks_dag.GetTotalJobsWithinHyperPeriod(), globalId);
+        // new periods renumber the jobs
+        tasks_dag.UpdatePeriod(0, tasks_dag.tasks_[0].period / 2);
+    }
+}
+TEST(BatchThreadNumber, Nasri19) {
+    int threads = batchThreadNumber;
+    batchThreadNumber = 4;
+    // Nasri19's time-out reads the CPU time of the whole process
+    CHECK_EQUAL(1, BatchThreadNumber(DAG_Nasri19::Type(), 0));
+    CHECK_EQUAL(1, BatchThreadNumber("Nasri19", 0));
+    CHECK_EQUAL(4, BatchThreadNumber(TaskSetNormal::Type(), 0));
+    // debugMode = 1 shares its prints and files
+    CHECK_EQUAL(1, BatchThreadNumber(TaskSetNormal::Type(), 1));
+    batchThreadNumber = threads;
+}
 
 int main() {
     TestResult tr;
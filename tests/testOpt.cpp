@@ -2,9 +2,11 @@
 
 #include <chrono>
 
+#include "sources/BatchRunner.h"
 #include "sources/EnergyOptimization/FactorGraphEnergyLL.h"
 #include "sources/EnergyOptimization/Optimize.h"
 #include "sources/Utils/FactorGraphUtils.h"
+#include "sources/Utils/JacobianBatch.h"
 #include "sources/Utils/Parameters.h"
 using namespace std::chrono;
 using namespace rt_num_opt;
@@ -112,6 +114,129 @@ TEST(NumericalDerivativeDynamic, A1) {
     EXPECT(assert_equal(H_Expect, H_Actual, 1e-3));
 }
 
+TEST(NumericalDerivativeDynamicBatch, A1) {
+    NormalErrorFunction1D f = [](const VectorDynamic &input) {
+        VectorDynamic err = GenerateVectorDynamic(3);
+        err << pow(input(0), 2), input(0) * input(1), 3 * input(1);
+        return err;
+    };
+    VectorDynamic x = GenerateVectorDynamic(2);
+    x << 4, 5;
+    MatrixDynamic H_Expect =
+        NumericalDerivativeDynamic(f, x, deltaOptimizer, 3);
+    MatrixDynamic H_Actual =
+        NumericalDerivativeDynamicBatch(f, x, deltaOptimizer, 3);
+    EXPECT(assert_equal(H_Expect, H_Actual, 1e-9));
+}
+
+TEST(NumericalDerivativeMultiKey, skip_key) {
+    std::vector<gtsam::Symbol> keyVec = {GenerateKey(0, "executionTime"),
+                                         GenerateKey(1, "executionTime")};
+    LambdaMultiKey f = [keyVec](const gtsam::Values &x) {
+        VectorDynamic err = GenerateVectorDynamic(1);
+        err(0) = 2 * x.at<VectorDynamic>(keyVec[0])(0) +
+                 pow(x.at<VectorDynamic>(keyVec[1])(0), 2);
+        return err;
+    };
+    gtsam::Values x;
+    x.insert(keyVec[0], GenerateVectorDynamic1D(1));
+    x.insert(keyVec[1], GenerateVectorDynamic1D(3));
+    std::vector<gtsam::Matrix> H =
+        NumericalDerivativeMultiKey(f, x, keyVec, deltaOptimizer, 1);
+    EXPECT_DOUBLES_EQUAL(2, H[0](0, 0), 1e-3);
+    EXPECT_DOUBLES_EQUAL(6, H[1](0, 0), 1e-3);
+    H = NumericalDerivativeMultiKey(f, x, keyVec, deltaOptimizer, 1,
+                                    {false, true});
+    EXPECT_DOUBLES_EQUAL(2, H[0](0, 0), 1e-3);
+    EXPECT_DOUBLES_EQUAL(0, H[1](0, 0), 1e-9);
+}
+
+TEST(OptimizationContext, scope) {
+    string path =
+        "/home/zephyr/Programming/Energy_Opt_NLP/TaskData/test_n5_v10.csv";
+    TaskSet tasks = ReadTaskSet(path, "RM");
+    size_t callsDefault = DefaultOptimizationContext().rtaCallingTimes;
+    OptimizationContext context;
+    {
+        OptimizationContextScope scope(context);
+        RTA_LL r(tasks);
+        r.ResponseTimeOfTaskSet();
+        CHECK_EQUAL(size_t(1), ReadCallingTimes());
+    }
+    CHECK_EQUAL(size_t(1), context.rtaCallingTimes.load());
+    CHECK_EQUAL(callsDefault, DefaultOptimizationContext().rtaCallingTimes);
+    CHECK_EQUAL(relativeErrorTolerance, context.relativeErrorTolerance);
+}
+
+TEST(RunBatchParallel, order) {
+    std::vector<double> cost = {1, 5, 3, 5};
+    std::vector<size_t> startOrder;
+    std::mutex mtx;
+    auto job = [&](size_t i) {
+        std::lock_guard<std::mutex> lock(mtx);
+        startOrder.push_back(i);
+        return int(i) * 10;
+    };
+    std::vector<int> res = RunBatchParallel<int>(cost, job, 1);
+    std::vector<size_t> startOrderExpect = {1, 3, 2, 0};
+    AssertEqualVectorExact(startOrderExpect, startOrder);
+    std::vector<int> resExpect = {0, 10, 20, 30};
+    AssertEqualVectorExact(resExpect, res);
+    AssertEqualVectorExact(resExpect, RunBatchParallel<int>(cost, job, 4));
+}
+
+TEST(OptimizationContext, time_limit) {
+    OptimizationContext context;
+    EXPECT(!context.TimeOut());
+    context.SetTimeLimit(1e-9);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    EXPECT(context.TimeOut());
+    context.SetTimeLimit(0);
+    EXPECT(!context.TimeOut());
+}
+
+TEST(SpeculativeBisection, same_as_serial) {
+    // not monotone, so that every level of the speculation matters
+    auto feasible = [](int x) { return x % 7 != 3 && x < 1000; };
+    for (int right : {0, 1, 2, 17, 100, 2000}) {
+        int left = 0, r = right;
+        while (left < r) {
+            int mid = ceil((left + r) / 2.0);
+            if (feasible(mid))
+                left = mid;
+            else
+                r = mid - 1;
+        }
+        for (int depth = 1; depth <= 4; depth++)
+            CHECK_EQUAL(left, SpeculativeBisection(0, right, feasible, depth));
+    }
+}
+
+TEST(SpeculativeBisection, rta_calls) {
+    // one RTA call per probe
+    auto feasible = [](int x) {
+        IncrementCallingTimes();
+        return x % 7 != 3 && x < 1000;
+    };
+    int left = 0, right = 2000;
+    size_t callsExpect = 0;
+    while (left < right) {
+        int mid = ceil((left + right) / 2.0);
+        callsExpect++;
+        if (feasible(mid))
+            left = mid;
+        else
+            right = mid - 1;
+    }
+    // only the probes of the serial bisection are counted
+    for (int depth = 1; depth <= 4; depth++) {
+        OptimizationContext context;
+        OptimizationContextScope scope(context);
+        CHECK_EQUAL(left, SpeculativeBisection(0, 2000, feasible, depth));
+        CHECK_EQUAL(callsExpect, context.rtaCallingTimes.load());
+    }
+}
+
 TEST(UpdateTaskSetExecutionTime, A1) {
     enableMaxComputationTimeRestrict = 0;
     MaxComputationTimeRestrict = 100;
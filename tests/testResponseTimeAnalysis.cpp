@@ -1,5 +1,7 @@
 #include <CppUnitLite/TestHarness.h>
 #include "sources/RTA/RTA_LL.h"
+#include "sources/RTA/RTA_LL_Batch.h"
+#include "sources/RTA/RTA_LL_Incremental.h"
 #include "sources/Tools/testMy.h"
 #include "sources/RTA/RTA_Melani.h"
 #include "sources/ControlOptimization/ControlOptimize.h"
@@ -67,6 +69,78 @@ TEST(RTA, RTA4)
     AssertEigenEqualVector(expect, actual);
 }
 
+TEST(RTA_LL_Incremental, v1)
+{
+    auto task_set = ReadTaskSet("/home/zephyr/Programming/Energy_Opt_NLP/TaskData/test_n30_v2.csv", "RM");
+    RTA_LL_Incremental rIncremental(task_set);
+    AssertEigenEqualVector(RTA_LL(task_set).ResponseTimeOfTaskSet(), rIncremental.ResponseTimeOfTaskSet());
+
+    // increase and decrease load, on both execution time and period
+    std::vector<std::pair<int, double>> execUpdates = {{20, 3}, {5, 2}, {5, -3}, {29, -1}, {0, 1}};
+    for (auto &p : execUpdates)
+    {
+        task_set[p.first].executionTime += p.second;
+        rIncremental.UpdateExecutionTime(p.first, task_set[p.first].executionTime);
+        AssertEigenEqualVector(RTA_LL(task_set).ResponseTimeOfTaskSet(), rIncremental.ResponseTimeOfTaskSet());
+    }
+    std::vector<std::pair<int, double>> periodUpdates = {{10, -50.5}, {3, 20}, {3, -40}};
+    for (auto &p : periodUpdates)
+    {
+        task_set[p.first].period += p.second;
+        rIncremental.UpdatePeriod(p.first, task_set[p.first].period);
+        AssertEigenEqualVector(RTA_LL(task_set).ResponseTimeOfTaskSet(), rIncremental.ResponseTimeOfTaskSet());
+        CHECK_EQUAL(RTA_LL(task_set).CheckSchedulability(), rIncremental.CheckSchedulability());
+    }
+
+    task_set[15].executionTime += 1e3;
+    rIncremental.UpdateTaskSet(task_set);
+    CHECK_EQUAL(RTA_LL(task_set).CheckSchedulability(), rIncremental.CheckSchedulability());
+    AssertEigenEqualVector(RTA_LL(task_set).ResponseTimeOfTaskSet(), rIncremental.ResponseTimeOfTaskSet());
+}
+
+TEST(InterferenceSum, v1)
+{
+    auto task_set = ReadTaskSet("/home/zephyr/Programming/Energy_Opt_NLP/TaskData/test_n30_v2.csv", "RM");
+    TaskSetSoA tasksSoA(task_set);
+    for (double r : {1.0, 17.5, 300.0, 1234.0})
+    {
+        for (int n : {0, 3, 8, 13, 30})
+        {
+            AssertEqualScalar(InterferenceSumScalar(r, tasksSoA.period.data(), tasksSoA.wcet.data(), n, 2),
+                              InterferenceSum(r, tasksSoA.period.data(), tasksSoA.wcet.data(), n, 2), 1e-9, __LINE__);
+        }
+    }
+}
+TEST(RTA_LL_Batch, v1)
+{
+    auto task_set = ReadTaskSet("/home/zephyr/Programming/Energy_Opt_NLP/TaskData/test_n30_v2.csv", "RM");
+    int N = task_set.size();
+    // central-difference perturbations of every execution time, plus an unschedulable one
+    std::vector<TaskSet> taskSets;
+    for (int i = 0; i < N; i++)
+    {
+        for (double delta : {1e-3, -1e-3})
+        {
+            TaskSet tasksCurr = task_set;
+            tasksCurr[i].executionTime += delta;
+            taskSets.push_back(tasksCurr);
+        }
+    }
+    taskSets.push_back(task_set);
+    taskSets.back()[3].executionTime += 1e3;
+
+    RTA_LL_Batch rBatch(taskSets);
+    MatrixDynamic rtaBatch = rBatch.ResponseTimeOfTaskSet();
+    std::vector<bool> schedulable = rBatch.CheckSchedulability();
+    for (uint k = 0; k < taskSets.size(); k++)
+    {
+        RTA_LL r(taskSets[k]);
+        AssertEigenEqualVector(r.ResponseTimeOfTaskSet(), rtaBatch.col(k));
+        CHECK_EQUAL(r.CheckSchedulability(), schedulable[k]);
+    }
+    CHECK_EQUAL(false, schedulable.back());
+}
+
 // TEST(GetBusyPeriod, v1)
 // {
 //     auto task_set = ReadTaskSet("/home/zephyr/Programming/Energy_Opt_NLP/TaskData/test_n5_v10.csv", "orig");
@@ -382,6 +456,62 @@ TEST(LL, vn1)
     VectorDynamic rta = r.ResponseTimeOfTaskSet();
     AssertEqualScalar(119, rta(3, 0));
 }
+TEST(SchedulabilityCache, LRU)
+{
+    SchedulabilityCache cache(2);
+    VectorDynamic value;
+    cache.Insert(1, GenerateVectorDynamic1D(1));
+    cache.Insert(2, GenerateVectorDynamic1D(2));
+    EXPECT(cache.Find(1, value));
+    CHECK_EQUAL(1, value(0));
+    // 2 is the least recently used one now
+    cache.Insert(3, GenerateVectorDynamic1D(3));
+    EXPECT(!cache.Find(2, value));
+    EXPECT(cache.Find(3, value));
+    CHECK_EQUAL(3, value(0));
+    CHECK_EQUAL(2u, cache.ReadSize());
+    cache.SetCapacity(0);
+    EXPECT(!cache.Enabled());
+    CHECK_EQUAL(0u, cache.ReadSize());
+}
+TEST(SchedulabilityCache, RTA_LL)
+{
+    auto task_set = ReadTaskSet("/home/zephyr/Programming/Energy_Opt_NLP/TaskData/test_n30_v2.csv", "RM");
+    SchedulabilityCache::Instance().Clear();
+    size_t hits = ReadCounter("SchedulabilityCache hit");
+    VectorDynamic rtaExpect = RTA_LL(task_set).ResponseTimeOfTaskSet();
+    AssertEigenEqualVector(rtaExpect, RTA_LL(task_set).ResponseTimeOfTaskSet());
+    CHECK_EQUAL(hits + 1, ReadCounter("SchedulabilityCache hit"));
+
+    // any change of the task set is a different entry
+    task_set[3].executionTime += 1;
+    RTA_LL r(task_set);
+    EXPECT(rtaExpect != r.ResponseTimeOfTaskSet());
+    CHECK_EQUAL(r.CheckSchedulabilityDirect(r.ResponseTimeOfTaskSet()), r.CheckSchedulability());
+    CHECK_EQUAL(r.CheckSchedulabilityDirect(r.ResponseTimeOfTaskSet()), r.CheckSchedulability());
+    CHECK_EQUAL(hits + 4, ReadCounter("SchedulabilityCache hit"));
+}
+TEST(SchedulabilityCache, rtaControl)
+{
+    auto task_set = ReadTaskSet("/home/zephyr/Programming/Energy_Opt_NLP/TaskData/test_n30_v2.csv", "RM");
+    // a cache hit counts the same as the analysis it replaces
+    auto analyze = [&task_set]() {
+        ResetCallingTimes();
+        for (int i = 0; i < 2; i++)
+        {
+            RTA_LL(task_set).ResponseTimeOfTaskSet();
+            RTA_LL(task_set).CheckSchedulability();
+        }
+        return ReadRTAControl();
+    };
+    SchedulabilityCache::Instance().Clear();
+    size_t cached = analyze();
+    SchedulabilityCache::Instance().SetCapacity(0);
+    size_t uncached = analyze();
+    SchedulabilityCache::Instance().SetCapacity(schedulabilityCacheSize);
+    EXPECT(uncached > 0);
+    CHECK_EQUAL(uncached, cached);
+}
 int main()
 {
     TestResult tr;
@@ -3,6 +3,7 @@
 #include <CppUnitLite/TestHarness.h>
 
 #include "sources/TaskModel/Tasks.h"
+#include "sources/TaskModel/TaskSetSoA.h"
 #include "sources/RTA/RTA_LL.h"
 #include "sources/RTA/RTA_Melani.h"
 #include "sources/Utils/Parameters.h"
@@ -87,6 +88,30 @@ TEST(ReadFrequencyModeRatio, v1)
     auto dagTasks = ReadTaskSet(path, "orig");
     AssertEqualScalar(0.296547, frequencyRatio);
 }
+TEST(GetParameterVD, compile_time)
+{
+    string path = "/home/zephyr/Programming/Energy_Opt_NLP/TaskData/test_n5_v10.csv";
+    TaskSet tasks = ReadTaskSet(path, "RM");
+    AssertEigenEqualVector(GetParameterVD<double>(tasks, "period"), GetParameterVD<double, &Task::period>(tasks));
+    AssertEigenEqualVector(GetParameterVD<int>(tasks, "executionTime"), GetParameterVD<int, &Task::executionTime>(tasks));
+    AssertBool(true, GetParameter<int>(tasks, "deadline") == GetParameter<int, &Task::deadline>(tasks));
+}
+TEST(TaskSetSoA, v1)
+{
+    string path = "/home/zephyr/Programming/Energy_Opt_NLP/TaskData/test_n5_v10.csv";
+    TaskSetNormal tasks(ReadTaskSet(path, "RM"));
+    TaskSetSoA tasksSoA(tasks);
+    CHECK_EQUAL(5, tasksSoA.N);
+    for (int i = 0; i < 5; i++)
+    {
+        AssertEqualScalar(tasks.tasks_[i].period, tasksSoA.period[i]);
+        AssertEqualScalar(tasks.tasks_[i].executionTime, tasksSoA.wcet[i]);
+        AssertEqualScalar(tasks.tasks_[i].deadline, tasksSoA.deadline[i]);
+    }
+    tasks.UpdateTaskSetParameter(2, 7.5, "executionTime");
+    tasksSoA.UpdateTaskSetParameter(2, 7.5, "executionTime");
+    AssertEqualScalar(tasks.tasks_[2].executionTime, tasksSoA.wcet[2]);
+}
 // TEST(ReadBaselineResult, v1)
 // {
 //     string path = "/home/zephyr/Programming/Energy_Opt_NLP/TaskData/task_number/periodic-set-000-syntheticJobs";